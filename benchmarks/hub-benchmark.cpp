@@ -0,0 +1,468 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+
+// Measures the hot paths of the C++ wrapper against the synthetic implementation of libmyo: the event loop of a Hub
+// with and without listeners, the lookup of Myos by handle, and the Quaternion and Vector3 math listeners typically
+// run on every orientation event. Each measurement reports its rate, its cost in nanoseconds and the number of heap
+// allocations it made per event or operation. Optionally it also disconnects the Myos repeatedly and reports how
+// long each took to stream EMG again once it reconnected.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <myo/myo.hpp>
+#include <myo/cxx/EulerAngles.hpp>
+#include <myo/cxx/HealthTable.hpp>
+
+#include "libmyo-synthetic.h"
+
+namespace {
+
+// Heap allocations made by the whole program, counted by the replacement operator new below.
+uint64_t allocations = 0;
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+struct Options {
+    unsigned int myos;
+    bool emg;
+    unsigned int listeners;
+    std::size_t batchSize;
+    bool commands;            // Listeners unlock the Myo and notify the user on every pose, as hello-myo does.
+    unsigned int commandRate;
+    unsigned int healthInterval; // Milliseconds between RSSI requests, and a tenth of those between battery requests.
+    unsigned int reconnects;  // Times each Myo is disconnected in the reconnection measurement.
+    unsigned int seconds;     // Synthetic time each event loop measurement runs for.
+    uint64_t iterations;      // Operations each lookup and math measurement performs.
+};
+
+// Keeps the compiler from discarding the work being measured.
+volatile float sink;
+
+class Measurement {
+public:
+    explicit Measurement(const char* name)
+    : _name(name)
+    , _allocations(allocations)
+    , _start(std::chrono::steady_clock::now())
+    {
+    }
+
+    // Print the results for \a count events or operations since construction.
+    void finish(uint64_t count)
+    {
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+        const double n = count ? static_cast<double>(count) : 1;
+        std::printf("%-34s %12llu %14.0f %10.1f %12.3f\n", _name, static_cast<unsigned long long>(count),
+                    count / seconds, seconds * 1e9 / n, (allocations - _allocations) / n);
+    }
+
+private:
+    const char* _name;
+    uint64_t _allocations;
+    std::chrono::steady_clock::time_point _start;
+};
+
+// A listener doing a token amount of work with every sample, so that the cost of handing events to it dominates.
+class CountingListener : public myo::DeviceListener {
+public:
+    CountingListener()
+    : events(0)
+    , checksum(0)
+    , commands(false)
+    {
+    }
+
+    void onPose(myo::Myo* myo, uint64_t timestamp, myo::Pose pose)
+    {
+        ++events;
+        checksum += pose.type();
+        if (commands) {
+            myo->unlock(myo::Myo::unlockHold);
+            myo->notifyUserAction();
+        }
+    }
+
+    void onOrientationData(myo::Myo* myo, uint64_t timestamp, const myo::Quaternion<float>& rotation)
+    {
+        ++events;
+        checksum += rotation.w();
+    }
+
+    void onAccelerometerData(myo::Myo* myo, uint64_t timestamp, const myo::Vector3<float>& accel)
+    {
+        checksum += accel.z();
+    }
+
+    void onGyroscopeData(myo::Myo* myo, uint64_t timestamp, const myo::Vector3<float>& gyro)
+    {
+        checksum += gyro.x();
+    }
+
+    void onEmgData(myo::Myo* myo, uint64_t timestamp, const int8_t* emg)
+    {
+        ++events;
+        checksum += emg[0];
+    }
+
+    void onEmgBatch(myo::Myo* myo, const myo::EmgBatch& batch)
+    {
+        checksum += batch.size;
+    }
+
+    void onImuBatch(myo::Myo* myo, const myo::ImuBatch& batch)
+    {
+        checksum += batch.size;
+    }
+
+    uint64_t events;
+    float checksum;
+    bool commands;
+};
+
+// Exposes the internals of Hub that are measured separately.
+class BenchmarkHub : public myo::Hub {
+public:
+    BenchmarkHub()
+    : Hub("com.thalmic.hub-benchmark")
+    {
+    }
+
+    using Hub::lookupMyo;
+
+    const std::vector<myo::Myo*>& myos() const { return _myos; }
+};
+
+void benchmarkLibmyo(const Options& options)
+{
+    struct local {
+        static libmyo_handler_result_t handler(void* user_data, libmyo_event_t event)
+        {
+            if (libmyo_event_get_type(event) == libmyo_event_paired && *static_cast<const bool*>(user_data)) {
+                libmyo_set_stream_emg(libmyo_event_get_myo(event), libmyo_stream_emg_enabled, 0);
+            }
+            return libmyo_handler_continue;
+        }
+    };
+
+    libmyo_hub_t hub = 0;
+    if (libmyo_init_hub(&hub, "com.thalmic.hub-benchmark", 0) != libmyo_success) {
+        throw std::runtime_error("Unable to create a synthetic hub");
+    }
+    bool emg = options.emg;
+    libmyo_run(hub, 1000, &local::handler, &emg, 0);
+
+    const uint64_t before = libmyo_synthetic_events(hub);
+    Measurement measurement("libmyo_run alone");
+    for (unsigned int s = 0; s < options.seconds; ++s) {
+        libmyo_run(hub, 1000, &local::handler, &emg, 0);
+    }
+    measurement.finish(libmyo_synthetic_events(hub) - before);
+
+    libmyo_shutdown_hub(hub, 0);
+}
+
+void benchmarkHub(const Options& options, unsigned int listenerCount, const char* name)
+{
+    BenchmarkHub hub;
+    hub.setBatchSize(options.batchSize);
+    hub.setCommandRate(options.commandRate);
+    myo::HealthTable health;
+    if (options.healthInterval) {
+        hub.setHealthPolling(options.healthInterval, options.healthInterval * 10);
+        hub.setHealthSink(&health);
+    }
+    // With batching, listeners take whole batches in place of the EMG and IMU samples.
+    uint32_t events = myo::Hub::allEvents;
+    if (options.batchSize) {
+        events = (events & ~(myo::Hub::eventEmg | myo::Hub::eventOrientation))
+                 | myo::Hub::eventEmgBatch | myo::Hub::eventImuBatch;
+    }
+    std::vector<CountingListener> listeners(listenerCount);
+    for (std::size_t i = 0; i < listeners.size(); ++i) {
+        listeners[i].commands = options.commands;
+        hub.addListener(&listeners[i], events);
+    }
+
+    // Pair the Myos and let the hub settle before measuring.
+    hub.run(5);
+    if (options.emg) {
+        for (std::size_t i = 0; i < hub.myos().size(); ++i) {
+            hub.myos()[i]->setStreamEmg(myo::Myo::streamEmgEnabled);
+        }
+    }
+    hub.run(1000);
+
+    const uint64_t before = libmyo_synthetic_events(hub.libmyoObject());
+    Measurement measurement(name);
+    for (unsigned int s = 0; s < options.seconds; ++s) {
+        hub.run(1000);
+    }
+    measurement.finish(libmyo_synthetic_events(hub.libmyoObject()) - before);
+
+    for (std::size_t i = 0; i < listeners.size(); ++i) {
+        sink = sink + listeners[i].checksum;
+    }
+}
+
+void benchmarkReconnect(const Options& options)
+{
+    BenchmarkHub hub;
+    hub.setCommandRate(options.commandRate);
+    hub.run(5);
+    for (std::size_t i = 0; i < hub.myos().size(); ++i) {
+        hub.myos()[i]->setStreamEmg(myo::Myo::streamEmgEnabled);
+    }
+    hub.run(1000);
+
+    // Each Myo is away for a second, and then has a second to start streaming again.
+    uint64_t reconnects = 0, streaming = 0, totalMicros = 0, maxMicros = 0;
+    for (unsigned int r = 0; r < options.reconnects; ++r) {
+        for (std::size_t i = 0; i < hub.myos().size(); ++i) {
+            libmyo_synthetic_disconnect(hub.libmyoObject(), static_cast<unsigned int>(i), 1000);
+        }
+        hub.run(2000);
+
+        for (std::size_t i = 0; i < hub.myos().size(); ++i) {
+            const myo::DeviceState& state = hub.state(hub.myos()[i]);
+            ++reconnects;
+            if (state.firstEmgTimestamp) {
+                const uint64_t micros = state.firstEmgTimestamp - state.connectedTimestamp;
+                ++streaming;
+                totalMicros += micros;
+                maxMicros = micros > maxMicros ? micros : maxMicros;
+            }
+        }
+    }
+
+    std::printf("\nReconnect to first EMG sample: %llu of %llu reconnections streamed EMG within 1 s",
+                static_cast<unsigned long long>(streaming), static_cast<unsigned long long>(reconnects));
+    if (streaming) {
+        std::printf(", mean %.1f ms, max %.1f ms", totalMicros / 1000.0 / streaming, maxMicros / 1000.0);
+    }
+    std::printf(" (synthetic time)\n");
+}
+
+void benchmarkLookup(const Options& options)
+{
+    BenchmarkHub hub;
+    hub.run(5);
+
+    std::vector<libmyo_myo_t> handles;
+    for (std::size_t i = 0; i < hub.myos().size(); ++i) {
+        handles.push_back(hub.myos()[i]->libmyoObject());
+    }
+    if (handles.empty()) {
+        return;
+    }
+
+    std::size_t found = 0;
+    Measurement measurement("Hub::lookupMyo");
+    for (uint64_t i = 0, j = 0; i < options.iterations; ++i) {
+        found += hub.lookupMyo(handles[j]) != 0;
+        j = j + 1 == handles.size() ? 0 : j + 1;
+    }
+    measurement.finish(options.iterations);
+    sink = sink + found;
+}
+
+void benchmarkMath(const Options& options)
+{
+    // Inputs cycle through a table small enough to stay in the L1 cache.
+    const std::size_t tableSize = 1024;
+    std::vector<myo::Quaternion<float> > quats;
+    std::vector<myo::Vector3<float> > vectors;
+    for (std::size_t i = 0; i < tableSize; ++i) {
+        const float t = static_cast<float>(i);
+        myo::Vector3<float> axis(std::sin(t), std::cos(0.7f * t), std::sin(1.3f * t) + 0.1f);
+        quats.push_back(myo::Quaternion<float>::fromAxisAngle(axis.normalized(), 0.01f * t));
+        vectors.push_back(myo::Vector3<float>(std::cos(t), 0.5f, std::sin(0.3f * t)));
+    }
+    const std::size_t mask = tableSize - 1;
+    const uint64_t n = options.iterations;
+
+    {
+        float sum = 0;
+        Measurement measurement("Quaternion multiply");
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += (quats[i & mask] * quats[(i + 1) & mask]).w();
+        }
+        measurement.finish(n);
+        sink = sink + sum;
+    }
+    {
+        float sum = 0;
+        Measurement measurement("Quaternion::normalized");
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += quats[i & mask].normalized().x();
+        }
+        measurement.finish(n);
+        sink = sink + sum;
+    }
+    {
+        float sum = 0;
+        Measurement measurement("rotate(Quaternion, Vector3)");
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += myo::rotate(quats[i & mask], vectors[i & mask]).y();
+        }
+        measurement.finish(n);
+        sink = sink + sum;
+    }
+    {
+        float sum = 0;
+        Measurement measurement("toEuler");
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += myo::toEuler(quats[i & mask]).pitch;
+        }
+        measurement.finish(n);
+        sink = sink + sum;
+    }
+    {
+        float sum = 0;
+        Measurement measurement("Vector3 cross and normalized");
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += vectors[i & mask].cross(vectors[(i + 1) & mask]).normalized().z();
+        }
+        measurement.finish(n);
+        sink = sink + sum;
+    }
+    {
+        float sum = 0;
+        Measurement measurement("Vector3::angleTo");
+        for (uint64_t i = 0; i < n; ++i) {
+            sum += vectors[i & mask].angleTo(vectors[(i + 1) & mask]);
+        }
+        measurement.finish(n);
+        sink = sink + sum;
+    }
+}
+
+void usage(const char* program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [options]\n"
+                 "  --myos N        number of synthetic Myos (default 1)\n"
+                 "  --emg on|off    stream EMG from every Myo (default on)\n"
+                 "  --listeners K   listeners registered with the hub (default 1)\n"
+                 "  --batch B       hub batch size, with listeners taking batches in place of EMG and IMU\n"
+                 "                  samples, 0 to disable batching (default 0)\n"
+                 "  --commands on|off\n"
+                 "                  listeners unlock the Myo and notify the user on every pose (default off)\n"
+                 "  --command-rate R\n"
+                 "                  queue commands and send at most R per second per Myo, 0 to send them\n"
+                 "                  as they are issued (default 0)\n"
+                 "  --health MS     poll the RSSI every MS and the battery level every 10 * MS milliseconds\n"
+                 "                  into a HealthTable, 0 to disable polling (default 0)\n"
+                 "  --reconnects N  disconnect every Myo N times and report how long each took to stream EMG\n"
+                 "                  again after reconnecting (default 0)\n"
+                 "  --seconds S     synthetic seconds of events per event loop measurement (default 3600)\n"
+                 "  --iterations I  operations per lookup and math measurement (default 10000000)\n",
+                 program);
+    std::exit(2);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options = { 1, true, 1, 0, false, 0, 0, 0, 3600, 10000000 };
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : 0;
+        if (!value) {
+            usage(argv[0]);
+        }
+        ++i;
+
+        if (!std::strcmp(arg, "--myos")) {
+            options.myos = static_cast<unsigned int>(std::atoi(value));
+        } else if (!std::strcmp(arg, "--emg")) {
+            if (std::strcmp(value, "on") && std::strcmp(value, "off")) {
+                usage(argv[0]);
+            }
+            options.emg = !std::strcmp(value, "on");
+        } else if (!std::strcmp(arg, "--listeners")) {
+            options.listeners = static_cast<unsigned int>(std::atoi(value));
+        } else if (!std::strcmp(arg, "--batch")) {
+            options.batchSize = static_cast<std::size_t>(std::atoi(value));
+        } else if (!std::strcmp(arg, "--commands")) {
+            if (std::strcmp(value, "on") && std::strcmp(value, "off")) {
+                usage(argv[0]);
+            }
+            options.commands = !std::strcmp(value, "on");
+        } else if (!std::strcmp(arg, "--command-rate")) {
+            options.commandRate = static_cast<unsigned int>(std::atoi(value));
+        } else if (!std::strcmp(arg, "--health")) {
+            options.healthInterval = static_cast<unsigned int>(std::atoi(value));
+        } else if (!std::strcmp(arg, "--reconnects")) {
+            options.reconnects = static_cast<unsigned int>(std::atoi(value));
+        } else if (!std::strcmp(arg, "--seconds")) {
+            options.seconds = static_cast<unsigned int>(std::atoi(value));
+        } else if (!std::strcmp(arg, "--iterations")) {
+            options.iterations = static_cast<uint64_t>(std::atoll(value));
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    libmyo_synthetic_set_myos(options.myos);
+
+    try {
+        std::printf("%u Myo%s, EMG %s, %u listener%s, batch size %u, %u s of events per event loop measurement\n\n",
+                    options.myos, options.myos == 1 ? "" : "s", options.emg ? "on" : "off", options.listeners,
+                    options.listeners == 1 ? "" : "s", static_cast<unsigned int>(options.batchSize), options.seconds);
+        std::printf("%-34s %12s %14s %10s %12s\n", "", "count", "per second", "ns each", "allocs each");
+
+        benchmarkLibmyo(options);
+        benchmarkHub(options, 0, "Hub::run, no listeners");
+        if (options.listeners) {
+            std::string name = "Hub::run, " + std::to_string(options.listeners) + " listener"
+                               + (options.listeners == 1 ? "" : "s");
+            benchmarkHub(options, options.listeners, name.c_str());
+        }
+        benchmarkLookup(options);
+        benchmarkMath(options);
+        if (options.reconnects) {
+            benchmarkReconnect(options);
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,528 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+
+// Synthetic implementation of the libmyo C API. Instead of connecting to Myo Connect, a hub makes up the events of a
+// fleet of Myos. See libmyo-synthetic.h for what is generated.
+
+#include "libmyo-synthetic.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ErrorDetails {
+    libmyo_result_t kind;
+    std::string message;
+};
+
+// Synthetic time advances in ticks of one EMG sample.
+const uint64_t tickMicros = 5000;
+const uint64_t ticksPerImuSample = 4;
+const uint64_t ticksPerPose = 200;
+
+// Length of the precomputed sample tables; a power of two.
+const unsigned int tableSize = 256;
+
+struct SyntheticMyo {
+    uint64_t macAddress;
+    unsigned int index;
+    bool streamEmg;
+    uint64_t commands;
+    uint32_t replies; // Event types to report on the next tick, as bits of libmyo_event_type_t.
+    bool connected;
+    bool disconnecting;   // Report a disconnection on the next tick.
+    uint64_t reconnectTick;
+};
+
+// The event handed to handlers. Payloads point into the sample tables of the hub.
+struct SyntheticEvent {
+    uint32_t type;
+    uint64_t timestamp;
+    SyntheticMyo* myo;
+    const float* imu;    // Orientation, accelerometer and gyroscope: 4 + 3 + 3 values.
+    const int8_t* emg;
+    libmyo_pose_t pose;
+};
+
+struct SyntheticHub {
+    explicit SyntheticHub(unsigned int count)
+    : myos(count)
+    , pending()
+    , position(0)
+    , tick(0)
+    , clock(0)
+    , events(0)
+    {
+        for (unsigned int i = 0; i < count; ++i) {
+            myos[i].macAddress = 0x0a0b0c000000ull + i;
+            myos[i].index = i;
+            myos[i].streamEmg = false;
+            myos[i].commands = 0;
+            myos[i].replies = 0;
+            myos[i].connected = true;
+            myos[i].disconnecting = false;
+            myos[i].reconnectTick = 0;
+        }
+
+        // The Myo sweeps back and forth about two axes while its muscles produce a noisy signal.
+        for (unsigned int k = 0; k < tableSize; ++k) {
+            const double phase = 2 * 3.14159265358979 * k / tableSize;
+            const double roll = 0.6 * std::sin(phase), pitch = 0.4 * std::sin(2 * phase);
+            float* imu = &imuTable[k * 10];
+            imu[0] = static_cast<float>(std::sin(roll / 2) * std::cos(pitch / 2));
+            imu[1] = static_cast<float>(std::cos(roll / 2) * std::sin(pitch / 2));
+            imu[2] = static_cast<float>(-std::sin(roll / 2) * std::sin(pitch / 2));
+            imu[3] = static_cast<float>(std::cos(roll / 2) * std::cos(pitch / 2));
+            imu[4] = static_cast<float>(-std::sin(pitch));
+            imu[5] = static_cast<float>(std::sin(roll) * std::cos(pitch));
+            imu[6] = static_cast<float>(std::cos(roll) * std::cos(pitch));
+            imu[7] = static_cast<float>(34 * std::cos(phase));
+            imu[8] = static_cast<float>(45 * std::cos(2 * phase));
+            imu[9] = 0;
+
+            for (unsigned int sensor = 0; sensor < 8; ++sensor) {
+                const int noise = static_cast<int>((k * 2654435761u + sensor * 40503u) >> 25) - 64;
+                emgTable[k * 8 + sensor] = static_cast<int8_t>(noise + 40 * std::sin(phase * (sensor + 1)));
+            }
+        }
+    }
+
+    void push(uint32_t type, uint64_t timestamp, SyntheticMyo& myo, unsigned int sample)
+    {
+        SyntheticEvent event;
+        event.type = type;
+        event.timestamp = timestamp;
+        event.myo = &myo;
+        event.imu = &imuTable[(sample & (tableSize - 1)) * 10];
+        event.emg = &emgTable[(sample & (tableSize - 1)) * 8];
+        event.pose = static_cast<libmyo_pose_t>(sample % libmyo_num_poses);
+        pending.push_back(event);
+    }
+
+    // Replace the pending events with those of the next tick.
+    void generate()
+    {
+        pending.clear();
+        position = 0;
+
+        const uint64_t timestamp = tick * tickMicros;
+        for (std::size_t i = 0, ie = myos.size(); i != ie; ++i) {
+            SyntheticMyo& myo = myos[i];
+            // Stagger the Myos so that they don't all report their orientation on the same tick.
+            const uint64_t local = tick + myo.index * 37;
+            const unsigned int sample = static_cast<unsigned int>(local);
+
+            if (myo.disconnecting) {
+                myo.disconnecting = false;
+                myo.connected = false;
+                push(libmyo_event_disconnected, timestamp, myo, sample);
+            }
+            if (!myo.connected) {
+                if (tick < myo.reconnectTick) {
+                    continue;
+                }
+                // The Myo comes back with its default settings, forgetting whatever it was sent in the meantime.
+                myo.connected = true;
+                myo.streamEmg = false;
+                myo.replies = 0;
+                push(libmyo_event_connected, timestamp, myo, sample);
+                push(libmyo_event_arm_synced, timestamp, myo, sample);
+                push(libmyo_event_locked, timestamp, myo, sample);
+            }
+
+            if (tick == 0) {
+                push(libmyo_event_paired, timestamp, myo, sample);
+                push(libmyo_event_connected, timestamp, myo, sample);
+                push(libmyo_event_arm_synced, timestamp, myo, sample);
+                push(libmyo_event_unlocked, timestamp, myo, sample);
+            }
+            for (uint32_t replies = myo.replies; replies; replies &= replies - 1) {
+                uint32_t type = 0;
+                while (!(replies & (1u << type))) {
+                    ++type;
+                }
+                push(type, timestamp, myo, sample);
+            }
+            myo.replies = 0;
+
+            if (myo.streamEmg) {
+                push(libmyo_event_emg, timestamp, myo, sample);
+            }
+            if (local % ticksPerImuSample == 0) {
+                push(libmyo_event_orientation, timestamp, myo, sample / ticksPerImuSample);
+            }
+            if (local % ticksPerPose == 0) {
+                push(libmyo_event_pose, timestamp, myo, static_cast<unsigned int>(local / ticksPerPose));
+            }
+        }
+
+        ++tick;
+    }
+
+    std::vector<SyntheticMyo> myos; // Never resized, so handles stay valid.
+    std::vector<SyntheticEvent> pending;
+    std::size_t position;
+    uint64_t tick;     // Next tick to generate.
+    uint64_t clock;    // Synthetic time, in microseconds, up to which events have been delivered.
+    uint64_t events;
+    float imuTable[tableSize * 10];
+    int8_t emgTable[tableSize * 8];
+};
+
+unsigned int myoCount = 1;
+bool myoCountSet = false;
+
+libmyo_result_t fail(libmyo_error_details_t* out_error, libmyo_result_t kind, const std::string& message)
+{
+    if (out_error) {
+        ErrorDetails* details = new ErrorDetails;
+        details->kind = kind;
+        details->message = message;
+        *out_error = details;
+    }
+    return kind;
+}
+
+libmyo_string_t makeString(const std::string& value)
+{
+    return new std::string(value);
+}
+
+const SyntheticEvent& synthetic(libmyo_event_t event)
+{
+    return *static_cast<const SyntheticEvent*>(event);
+}
+
+// Count a command sent to \a myo and schedule the event, if any, that answers it.
+libmyo_result_t command(libmyo_myo_t myo, int reply, libmyo_error_details_t* out_error)
+{
+    if (!myo) {
+        return fail(out_error, libmyo_error_invalid_argument, "myo is NULL");
+    }
+
+    SyntheticMyo* synthetic = static_cast<SyntheticMyo*>(myo);
+    ++synthetic->commands;
+    if (reply >= 0) {
+        synthetic->replies |= 1u << reply;
+    }
+    return libmyo_success;
+}
+
+} // namespace
+
+extern "C" {
+
+void libmyo_synthetic_set_myos(unsigned int count)
+{
+    myoCount = count;
+    myoCountSet = true;
+}
+
+uint64_t libmyo_synthetic_events(libmyo_hub_t hub)
+{
+    return hub ? static_cast<SyntheticHub*>(hub)->events : 0;
+}
+
+void libmyo_synthetic_disconnect(libmyo_hub_t hub, unsigned int index, unsigned int duration_ms)
+{
+    SyntheticHub* synthetic = static_cast<SyntheticHub*>(hub);
+    if (!synthetic || index >= synthetic->myos.size()) {
+        return;
+    }
+
+    SyntheticMyo& myo = synthetic->myos[index];
+    myo.disconnecting = myo.connected;
+    myo.reconnectTick = synthetic->tick + 1 + (duration_ms * 1000ull + tickMicros - 1) / tickMicros;
+}
+
+uint64_t libmyo_synthetic_commands(libmyo_hub_t hub)
+{
+    if (!hub) {
+        return 0;
+    }
+
+    const std::vector<SyntheticMyo>& myos = static_cast<SyntheticHub*>(hub)->myos;
+    uint64_t commands = 0;
+    for (std::size_t i = 0, ie = myos.size(); i != ie; ++i) {
+        commands += myos[i].commands;
+    }
+    return commands;
+}
+
+const char* libmyo_error_cstring(libmyo_error_details_t details)
+{
+    return static_cast<ErrorDetails*>(details)->message.c_str();
+}
+
+libmyo_result_t libmyo_error_kind(libmyo_error_details_t details)
+{
+    return static_cast<ErrorDetails*>(details)->kind;
+}
+
+void libmyo_free_error_details(libmyo_error_details_t details)
+{
+    delete static_cast<ErrorDetails*>(details);
+}
+
+const char* libmyo_string_c_str(libmyo_string_t string)
+{
+    return static_cast<std::string*>(string)->c_str();
+}
+
+void libmyo_string_free(libmyo_string_t string)
+{
+    delete static_cast<std::string*>(string);
+}
+
+libmyo_string_t libmyo_mac_address_to_string(uint64_t address)
+{
+    char buffer[18];
+    std::sprintf(buffer, "%02x-%02x-%02x-%02x-%02x-%02x",
+                 static_cast<unsigned int>((address >> 40) & 0xff), static_cast<unsigned int>((address >> 32) & 0xff),
+                 static_cast<unsigned int>((address >> 24) & 0xff), static_cast<unsigned int>((address >> 16) & 0xff),
+                 static_cast<unsigned int>((address >> 8) & 0xff), static_cast<unsigned int>(address & 0xff));
+    return makeString(buffer);
+}
+
+uint64_t libmyo_string_to_mac_address(const char* string)
+{
+    unsigned int bytes[6];
+    char trailing;
+    if (!string || std::sscanf(string, "%2x-%2x-%2x-%2x-%2x-%2x%c", &bytes[0], &bytes[1], &bytes[2], &bytes[3],
+                               &bytes[4], &bytes[5], &trailing) != 6) {
+        return 0;
+    }
+
+    uint64_t address = 0;
+    for (int i = 0; i < 6; ++i) {
+        address = (address << 8) | bytes[i];
+    }
+    return address;
+}
+
+libmyo_result_t libmyo_init_hub(libmyo_hub_t* out_hub, const char* application_identifier,
+                                libmyo_error_details_t* out_error)
+{
+    if (!out_hub) {
+        return fail(out_error, libmyo_error_invalid_argument, "out_hub is NULL");
+    }
+    if (application_identifier && std::strlen(application_identifier) > 255) {
+        return fail(out_error, libmyo_error_invalid_argument, "application_identifier is too long");
+    }
+
+    unsigned int count = myoCount;
+    if (!myoCountSet) {
+        const char* myos = std::getenv("MYO_SYNTHETIC_MYOS");
+        count = myos ? static_cast<unsigned int>(std::atoi(myos)) : 1;
+    }
+
+    *out_hub = new SyntheticHub(count);
+    return libmyo_success;
+}
+
+libmyo_result_t libmyo_shutdown_hub(libmyo_hub_t hub, libmyo_error_details_t* out_error)
+{
+    if (!hub) {
+        return fail(out_error, libmyo_error_invalid_argument, "hub is NULL");
+    }
+    delete static_cast<SyntheticHub*>(hub);
+    return libmyo_success;
+}
+
+libmyo_result_t libmyo_set_locking_policy(libmyo_hub_t hub, libmyo_locking_policy_t locking_policy,
+                                          libmyo_error_details_t* out_error)
+{
+    if (!hub) {
+        return fail(out_error, libmyo_error_invalid_argument, "hub is NULL");
+    }
+    return libmyo_success;
+}
+
+uint64_t libmyo_get_mac_address(libmyo_myo_t myo)
+{
+    return myo ? static_cast<SyntheticMyo*>(myo)->macAddress : 0;
+}
+
+libmyo_result_t libmyo_vibrate(libmyo_myo_t myo, libmyo_vibration_type_t type, libmyo_error_details_t* out_error)
+{
+    return command(myo, -1, out_error);
+}
+
+libmyo_result_t libmyo_request_rssi(libmyo_myo_t myo, libmyo_error_details_t* out_error)
+{
+    return command(myo, libmyo_event_rssi, out_error);
+}
+
+libmyo_result_t libmyo_request_battery_level(libmyo_myo_t myo, libmyo_error_details_t* out_error)
+{
+    return command(myo, libmyo_event_battery_level, out_error);
+}
+
+libmyo_result_t libmyo_set_stream_emg(libmyo_myo_t myo, libmyo_stream_emg_t emg, libmyo_error_details_t* out_error)
+{
+    libmyo_result_t result = command(myo, -1, out_error);
+    if (result == libmyo_success) {
+        static_cast<SyntheticMyo*>(myo)->streamEmg = emg == libmyo_stream_emg_enabled;
+    }
+    return result;
+}
+
+libmyo_result_t libmyo_myo_unlock(libmyo_myo_t myo, libmyo_unlock_type_t type, libmyo_error_details_t* out_error)
+{
+    return command(myo, libmyo_event_unlocked, out_error);
+}
+
+libmyo_result_t libmyo_myo_lock(libmyo_myo_t myo, libmyo_error_details_t* out_error)
+{
+    return command(myo, libmyo_event_locked, out_error);
+}
+
+libmyo_result_t libmyo_myo_notify_user_action(libmyo_myo_t myo, libmyo_user_action_type_t type,
+                                              libmyo_error_details_t* out_error)
+{
+    return command(myo, -1, out_error);
+}
+
+uint32_t libmyo_event_get_type(libmyo_event_t event)
+{
+    return synthetic(event).type;
+}
+
+uint64_t libmyo_event_get_timestamp(libmyo_event_t event)
+{
+    return synthetic(event).timestamp;
+}
+
+libmyo_myo_t libmyo_event_get_myo(libmyo_event_t event)
+{
+    return synthetic(event).myo;
+}
+
+uint64_t libmyo_event_get_mac_address(libmyo_event_t event)
+{
+    return synthetic(event).myo->macAddress;
+}
+
+libmyo_string_t libmyo_event_get_myo_name(libmyo_event_t event)
+{
+    char buffer[32];
+    std::sprintf(buffer, "Synthetic Myo %u", synthetic(event).myo->index);
+    return makeString(buffer);
+}
+
+unsigned int libmyo_event_get_firmware_version(libmyo_event_t event, libmyo_version_component_t component)
+{
+    switch (component) {
+    case libmyo_version_major:
+        return 1;
+    case libmyo_version_minor:
+        return 5;
+    case libmyo_version_patch:
+        return 1970;
+    case libmyo_version_hardware_rev:
+        return libmyo_hardware_rev_d;
+    }
+    return 0;
+}
+
+libmyo_arm_t libmyo_event_get_arm(libmyo_event_t event)
+{
+    return synthetic(event).myo->index % 2 ? libmyo_arm_left : libmyo_arm_right;
+}
+
+libmyo_x_direction_t libmyo_event_get_x_direction(libmyo_event_t event)
+{
+    return libmyo_x_direction_toward_wrist;
+}
+
+libmyo_warmup_state_t libmyo_event_get_warmup_state(libmyo_event_t event)
+{
+    return libmyo_warmup_state_warm;
+}
+
+libmyo_warmup_result_t libmyo_event_get_warmup_result(libmyo_event_t event)
+{
+    return libmyo_warmup_result_success;
+}
+
+float libmyo_event_get_rotation_on_arm(libmyo_event_t event)
+{
+    return 0;
+}
+
+float libmyo_event_get_orientation(libmyo_event_t event, libmyo_orientation_index index)
+{
+    return synthetic(event).imu[index];
+}
+
+float libmyo_event_get_accelerometer(libmyo_event_t event, unsigned int index)
+{
+    return synthetic(event).imu[4 + index];
+}
+
+float libmyo_event_get_gyroscope(libmyo_event_t event, unsigned int index)
+{
+    return synthetic(event).imu[7 + index];
+}
+
+libmyo_pose_t libmyo_event_get_pose(libmyo_event_t event)
+{
+    return synthetic(event).pose;
+}
+
+int8_t libmyo_event_get_rssi(libmyo_event_t event)
+{
+    return static_cast<int8_t>(-50 - static_cast<int>(synthetic(event).myo->index % 30));
+}
+
+uint8_t libmyo_event_get_battery_level(libmyo_event_t event)
+{
+    return static_cast<uint8_t>(100 - synthetic(event).myo->index % 80);
+}
+
+int8_t libmyo_event_get_emg(libmyo_event_t event, unsigned int sensor)
+{
+    return synthetic(event).emg[sensor];
+}
+
+libmyo_result_t libmyo_run(libmyo_hub_t hub_opq, unsigned int duration_ms, libmyo_handler_t handler, void* user_data,
+                           libmyo_error_details_t* out_error)
+{
+    if (!hub_opq) {
+        return fail(out_error, libmyo_error_invalid_argument, "hub is NULL");
+    }
+    if (!handler) {
+        return fail(out_error, libmyo_error_invalid_argument, "handler is NULL");
+    }
+
+    SyntheticHub* hub = static_cast<SyntheticHub*>(hub_opq);
+    const uint64_t end = hub->clock + static_cast<uint64_t>(duration_ms) * 1000;
+
+    for (;;) {
+        if (hub->position == hub->pending.size()) {
+            if (hub->tick * tickMicros > end) {
+                break;
+            }
+            hub->generate();
+            continue;
+        }
+
+        const SyntheticEvent& event = hub->pending[hub->position++];
+        hub->clock = event.timestamp;
+        ++hub->events;
+
+        if (handler(user_data, &event) == libmyo_handler_stop) {
+            return libmyo_success;
+        }
+    }
+
+    hub->clock = end;
+    return libmyo_success;
+}
+
+} // extern "C"
@@ -0,0 +1,52 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_LIBMYO_SYNTHETIC_H
+#define MYO_LIBMYO_SYNTHETIC_H
+
+#include <myo/libmyo.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @file libmyo-synthetic.h
+/// Controls specific to the synthetic implementation of libmyo.
+///
+/// The synthetic implementation makes up the events of a fleet of Myos in place of talking to Myo Connect, so that
+/// the event loop of the C++ wrapper can be measured without hardware. On its first run a hub pairs, connects, syncs
+/// and unlocks each Myo. After that each Myo reports its orientation at 50 Hz and, once EMG streaming has been enabled
+/// for it with libmyo_set_stream_emg(), EMG at 200 Hz, and changes its pose once a second. Requests for RSSI or the
+/// battery level and lock commands are answered with the matching event 5 ms later. Myos can be made to drop their
+/// connection with libmyo_synthetic_disconnect().
+///
+/// Events are generated from precomputed tables, so producing one costs a few nanoseconds. Like the replay
+/// implementation, each call to libmyo_run() advances the hub by exactly \a duration_ms milliseconds of synthetic
+/// time, delivering the events as fast as the handler takes them.
+///
+/// The number of Myos can also be chosen with the MYO_SYNTHETIC_MYOS environment variable, which is read by
+/// libmyo_init_hub() unless overridden with libmyo_synthetic_set_myos().
+
+/// Set the number of Myos the next call to libmyo_init_hub() will make up. The default is one.
+LIBMYO_EXPORT
+void libmyo_synthetic_set_myos(unsigned int count);
+
+/// Return the number of events \a hub has delivered to handlers.
+LIBMYO_EXPORT
+uint64_t libmyo_synthetic_events(libmyo_hub_t hub);
+
+/// Disconnect the Myo at \a index among those of \a hub on the next tick and connect it again \a duration_ms
+/// milliseconds later. Like a real Myo, it comes back with EMG streaming disabled and locked, reporting its arm sync
+/// but not the commands it was sent while away, so it only streams EMG again once libmyo_set_stream_emg() is called.
+LIBMYO_EXPORT
+void libmyo_synthetic_disconnect(libmyo_hub_t hub, unsigned int index, unsigned int duration_ms);
+
+/// Return the number of commands sent to the Myos of \a hub: vibrations, RSSI and battery level requests, changes to
+/// the EMG stream, locks, unlocks and user action notifications.
+LIBMYO_EXPORT
+uint64_t libmyo_synthetic_commands(libmyo_hub_t hub);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // MYO_LIBMYO_SYNTHETIC_H
@@ -0,0 +1,76 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <stdint.h>
+
+#include <myo/libmyo.h>
+
+#include "DeviceListener.hpp"
+#include "Pose.hpp"
+
+namespace myo {
+
+class Myo;
+
+/// A device event whose payload has been read out of libmyo.
+/// A DeviceEvent is a plain data structure: it can be copied freely and remains valid after the libmyo_event_t it
+/// was decoded from has gone out of scope. Only the payload member matching \a type holds meaningful data.
+struct DeviceEvent {
+    /// Arm sync payload, valid for libmyo_event_arm_synced events.
+    struct ArmSync {
+        Arm arm;
+        XDirection xDirection;
+        float rotation;
+        WarmupState warmupState;
+    };
+
+    /// IMU payload, valid for libmyo_event_orientation events.
+    struct Imu {
+        float orientation[4];   ///< Unit quaternion, indexed by libmyo_orientation_index.
+        float accelerometer[3]; ///< Acceleration in units of g.
+        float gyroscope[3];     ///< Angular velocity in units of deg/s.
+    };
+
+    libmyo_event_type_t type; ///< The kind of event.
+    uint64_t timestamp;       ///< Microseconds, as returned by libmyo_event_get_timestamp().
+    Myo* myo;                 ///< The Myo that generated the event.
+
+    union {
+        FirmwareVersion firmwareVersion; ///< Valid for libmyo_event_paired and libmyo_event_connected.
+        ArmSync armSync;                 ///< Valid for libmyo_event_arm_synced.
+        Imu imu;                         ///< Valid for libmyo_event_orientation.
+        Pose::Type pose;                 ///< Valid for libmyo_event_pose.
+        int8_t rssi;                     ///< Valid for libmyo_event_rssi.
+        uint8_t batteryLevel;            ///< Valid for libmyo_event_battery_level.
+        int8_t emg[8];                   ///< Valid for libmyo_event_emg.
+        WarmupResult warmupResult;       ///< Valid for libmyo_event_warmup_completed.
+    };
+};
+
+/// Interface for objects that take decoded events from a Hub in place of its listeners.
+/// @see Hub::setEventSink()
+class DeviceEventSink {
+public:
+    virtual ~DeviceEventSink() {}
+
+    /// Accept \a event. Return false if the event had to be discarded.
+    virtual bool push(const DeviceEvent& event) = 0;
+};
+
+/// Read the type, timestamp and payload of \a event into \a out, attributing it to \a myo.
+/// Each libmyo accessor relevant to the event type is called exactly once.
+void decodeEvent(libmyo_event_t event, Myo* myo, DeviceEvent& out);
+
+/// Read only the type and timestamp of \a event into \a out, attributing it to \a myo. The payload is left as is.
+void decodeEventHeader(libmyo_event_t event, Myo* myo, DeviceEvent& out);
+
+/// Read the payload of \a event into \a out, whose header must already have been read by decodeEventHeader().
+void decodeEventPayload(libmyo_event_t event, DeviceEvent& out);
+
+/// Invoke the DeviceListener callback(s) of \a listener that correspond to \a event.
+void dispatchEvent(DeviceListener* listener, const DeviceEvent& event);
+
+} // namespace myo
+
+#include "impl/DeviceEvent_impl.hpp"
@@ -0,0 +1,37 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+
+namespace myo {
+
+/// What a Hub knows about the link to one Myo. Timestamps are those of the events they were taken from, in
+/// microseconds; a timestamp of zero means nothing has been received yet.
+/// @see Hub::setHealthPolling()
+struct DeviceHealth {
+    uint64_t macAddress;
+    uint64_t lastSeen;           ///< Timestamp of the latest event of any type from the Myo.
+    uint64_t rssiTimestamp;      ///< Timestamp of the latest RSSI.
+    uint64_t batteryTimestamp;   ///< Timestamp of the latest battery level.
+    float smoothedRssi;          ///< Exponential moving average of the RSSI readings, in dBm.
+    uint32_t missedRequests;     ///< RSSI and battery level requests that were not answered before the next one.
+    int8_t rssi;                 ///< Latest RSSI, in dBm.
+    uint8_t batteryLevel;        ///< Latest battery level, in percent.
+    bool connected;
+};
+
+/// Interface for objects that receive the health records of the Myos of a Hub as they change.
+/// @see Hub::setHealthSink(), HealthTable
+class DeviceHealthSink {
+public:
+    virtual ~DeviceHealthSink() {}
+
+    /// Accept the current record of the Myo at position \a index in the Hub's list of Myos. Indices start at zero
+    /// and stay the same for the lifetime of the Hub.
+    virtual void update(std::size_t index, const DeviceHealth& health) = 0;
+};
+
+} // namespace myo
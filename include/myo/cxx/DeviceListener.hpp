@@ -2,6 +2,7 @@
 // Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "Pose.hpp"
@@ -50,6 +51,24 @@ struct FirmwareVersion {
     unsigned int firmwareVersionHardwareRev; ///< Myo's hardware revision; not used to detect firmware version mismatch.
 };
 
+/// A block of consecutive EMG samples from one Myo, in structure-of-arrays layout.
+/// @see Hub::setBatchSize()
+struct EmgBatch {
+    size_t size;                ///< Number of samples in the batch.
+    const uint64_t* timestamps; ///< Timestamp of each sample, \a size elements.
+    const int8_t* channels[8];  ///< channels[sensor][i] is the reading of \a sensor in sample i, \a size elements each.
+};
+
+/// A block of consecutive IMU samples from one Myo, in structure-of-arrays layout.
+/// @see Hub::setBatchSize()
+struct ImuBatch {
+    size_t size;                   ///< Number of samples in the batch.
+    const uint64_t* timestamps;    ///< Timestamp of each sample, \a size elements.
+    const float* orientation[4];   ///< Quaternion components indexed by libmyo_orientation_index, \a size elements each.
+    const float* accelerometer[3]; ///< Acceleration along x, y and z in units of g, \a size elements each.
+    const float* gyroscope[3];     ///< Angular velocity about x, y and z in units of deg/s, \a size elements each.
+};
+
 /// A DeviceListener receives events about a Myo.
 /// @see Hub::addListener()
 class DeviceListener {
@@ -179,6 +198,22 @@ public:
     /// @param emg An array of 8 elements, each corresponding to one sensor.
     virtual void onEmgData(myo::Myo* myo, uint64_t timestamp, const int8_t* emg) {}
 
+    /// Called with a block of EMG samples once Hub has accumulated a full batch for a Myo, or when a partial batch is
+    /// flushed. Only called if batching has been enabled with Hub::setBatchSize() and the listener is subscribed to
+    /// Hub::eventEmgBatch. The samples are only also delivered to onEmgData() if the listener is subscribed to
+    /// Hub::eventEmg as well.
+    /// @param myo The Myo for this event.
+    /// @param batch The samples. The pointers in \a batch are only valid for the duration of the call.
+    virtual void onEmgBatch(myo::Myo* myo, const EmgBatch& batch) {}
+
+    /// Called with a block of IMU samples once Hub has accumulated a full batch for a Myo, or when a partial batch is
+    /// flushed. Only called if batching has been enabled with Hub::setBatchSize() and the listener is subscribed to
+    /// Hub::eventImuBatch. The samples are only also delivered to onOrientationData(), onAccelerometerData() and
+    /// onGyroscopeData() if the listener is subscribed to Hub::eventOrientation as well.
+    /// @param myo The Myo for this event.
+    /// @param batch The samples. The pointers in \a batch are only valid for the duration of the call.
+    virtual void onImuBatch(myo::Myo* myo, const ImuBatch& batch) {}
+
     /// Called when the warmup period for a Myo has completed.
     /// @param myo The Myo for this event.
     /// @param timestamp The timestamp of when the event is received by the SDK. Timestamps are 64 bit unsigned
@@ -0,0 +1,33 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <stdint.h>
+
+#include "DeviceListener.hpp"
+
+namespace myo {
+
+/// What a Hub knows about the state of one Myo, kept up to date from the Myo's events whether or not any listener is
+/// subscribed to them, along with the configuration the application last asked of it. Timestamps are those of the
+/// events they were taken from, in microseconds.
+/// @see Hub::state()
+struct DeviceState {
+    bool paired;
+    bool connected;
+    bool armSynced;
+    bool unlocked;
+    Arm arm;                     ///< As of the latest arm sync; armUnknown while not synced.
+    XDirection xDirection;       ///< As of the latest arm sync; xDirectionUnknown while not synced.
+    float rotation;              ///< As of the latest arm sync.
+    WarmupState warmupState;     ///< As of the latest arm sync.
+    WarmupResult warmupResult;   ///< As of the latest warmup completed event.
+    bool streamEmg;              ///< The latest call to Myo::setStreamEmg() enabled EMG streaming.
+    bool unlockHold;             ///< The latest call to Myo::unlock() or Myo::lock() was a hold unlock.
+    uint32_t connections;        ///< Number of connected events received.
+    uint32_t restoreFailures;    ///< Number of times the configuration could not be sent again on connection.
+    uint64_t connectedTimestamp; ///< Timestamp of the latest connected event.
+    uint64_t firstEmgTimestamp;  ///< Timestamp of the first EMG sample since then, or zero if none has arrived yet.
+};
+
+} // namespace myo
@@ -0,0 +1,32 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <stdint.h>
+
+namespace myo {
+
+class DeviceListener;
+
+/// Receives hooks from a hub's event loop around the handling of each event, for measuring where the time goes.
+/// Event types are libmyo_event_type_t values. All hooks are called on the thread that calls the listeners, except
+/// onEventReceived(), which is called on the thread running the event loop even if events are diverted to a sink.
+/// @see Hub::setDispatchObserver(), HubProfiler
+class DispatchObserver {
+public:
+    virtual ~DispatchObserver() {}
+
+    /// Called when the hub receives an event from libmyo, before anything else is done with it.
+    virtual void onEventReceived(uint32_t type, uint64_t timestamp) {}
+
+    /// Called right before \a listener is handed an event of \a type, including batches of EMG or IMU samples.
+    virtual void onListenerBegin(DeviceListener* listener, uint32_t type) {}
+
+    /// Called right after \a listener has returned from handling an event of \a type.
+    virtual void onListenerEnd(DeviceListener* listener, uint32_t type) {}
+
+    /// Called once every listener subscribed to an event has handled it.
+    virtual void onEventHandled(uint32_t type, uint64_t timestamp) {}
+};
+
+} // namespace myo
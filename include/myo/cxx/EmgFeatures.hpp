@@ -0,0 +1,87 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "DeviceListener.hpp"
+#include "detail/MyoTracks.hpp"
+
+namespace myo {
+
+class Myo;
+
+/// Time-domain features of the EMG signal of each of the 8 sensors over a window of samples.
+struct EmgFeatures {
+    uint64_t timestamp;       ///< Timestamp of the newest sample in the window.
+    std::size_t window;       ///< Number of samples in the window.
+    float rms[8];             ///< Root mean square of each sensor's readings.
+    float mav[8];             ///< Mean absolute value of each sensor's readings.
+    float zeroCrossings[8];   ///< Number of sign changes between consecutive readings of each sensor.
+    float waveformLength[8];  ///< Sum of the absolute differences between consecutive readings of each sensor.
+};
+
+/// A DeviceListener that computes EmgFeatures over a sliding window of the EMG stream of each Myo.
+///
+/// The features are kept as running integer sums that are updated as each sample enters and leaves the window, so
+/// every sample costs the same few operations on all 8 sensors at once regardless of the window length, and the sums
+/// never drift. Once the window is full, features are emitted every \a hop samples. A sign change only counts as a
+/// zero crossing if the readings on either side differ by at least \a zeroCrossingThreshold, so that noise around
+/// zero is ignored.
+///
+/// Subscribed to Hub::eventEmgBatch in place of Hub::eventEmg on a hub that batches EMG samples (see
+/// Hub::setBatchSize()), the extractor works on whole batches; otherwise it handles one sample at a time. It must not
+/// be subscribed to both, or each sample enters the window twice. Once the window of a Myo has been created on its
+/// first sample, neither path allocates memory.
+class EmgFeatureExtractor : public DeviceListener {
+public:
+    /// Create an extractor over windows of \a window samples, emitting features every \a hop samples.
+    /// Throws an exception of type std::invalid_argument if \a window is less than 2 or \a hop is 0.
+    explicit EmgFeatureExtractor(std::size_t window = 40, std::size_t hop = 10, int zeroCrossingThreshold = 2);
+
+    /// Return the number of samples in a window.
+    std::size_t window() const { return _window; }
+
+    /// Return the number of samples between two feature vectors.
+    std::size_t hop() const { return _hop; }
+
+    /// Empty the window of every Myo.
+    void reset();
+
+    /// Called with the features of the window ending at the latest sample of \a myo, every hop samples.
+    virtual void onEmgFeatures(Myo* myo, const EmgFeatures& features) {}
+
+    void onEmgData(Myo* myo, uint64_t timestamp, const int8_t* emg);
+    void onEmgBatch(Myo* myo, const EmgBatch& batch);
+    void onDisconnect(Myo* myo, uint64_t timestamp);
+    void onUnpair(Myo* myo, uint64_t timestamp);
+
+private:
+    struct Track {
+        uint64_t count;       // Samples received so far.
+        uint64_t lastTimestamp;
+        std::size_t position; // Slot of the oldest sample in the ring.
+        std::size_t untilHop;
+        int32_t sumSquares[8];
+        int32_t sumAbs[8];
+        int32_t crossings[8];
+        int32_t length[8];
+        std::vector<int8_t> ring; // _window samples of 8 readings each.
+    };
+
+    Track& track(Myo* myo);
+    void addSample(Myo* myo, Track& track, uint64_t timestamp, const int8_t* emg);
+    void emit(Myo* myo, const Track& track);
+
+    std::size_t _window;
+    std::size_t _hop;
+    int _zeroCrossingThreshold;
+    MyoTracks<Track> _tracks;
+};
+
+} // namespace myo
+
+#include "impl/EmgFeatures_impl.hpp"
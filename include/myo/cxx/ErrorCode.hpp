@@ -0,0 +1,67 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <myo/libmyo.h>
+
+namespace myo {
+
+/// Receives the outcome of a call to an ErrorCode overload of a Hub or Myo function.
+///
+/// Those overloads report failures here instead of throwing, so they can be used from code built without exceptions
+/// or on threads that must not unwind. An ErrorCode holds a single libmyo error details slot that is reused by every
+/// call it is passed to: the details of a previous failure are released when the next call starts, and the wrapper
+/// itself never allocates. The ErrorCode reflects the most recent call only.
+class ErrorCode {
+public:
+    /// Construct an ErrorCode that indicates success.
+    ErrorCode()
+    : _details(0)
+    {
+    }
+
+    /// Release the details of the last failure, if any.
+    ~ErrorCode()
+    {
+        clear();
+    }
+
+    /// Return true if the most recent call failed.
+    bool failed() const { return _details != 0 && libmyo_error_kind(_details) != libmyo_success; }
+
+    /// Return the kind of failure of the most recent call, or libmyo_success if it succeeded.
+    libmyo_result_t kind() const { return _details ? libmyo_error_kind(_details) : libmyo_success; }
+
+    /// Return a description of the failure of the most recent call, or an empty string if it succeeded.
+    /// The string remains valid until the ErrorCode is passed to another call, cleared or destroyed.
+    const char* message() const { return _details ? libmyo_error_cstring(_details) : ""; }
+
+    /// Release the details of the last failure and indicate success.
+    void clear()
+    {
+        if (_details) {
+            libmyo_free_error_details(_details);
+            _details = 0;
+        }
+    }
+
+    /// @cond MYO_INTERNALS
+
+    /// Prepare the slot for another call and return it.
+    operator libmyo_error_details_t*()
+    {
+        clear();
+        return &_details;
+    }
+
+    /// @endcond
+
+private:
+    libmyo_error_details_t _details;
+
+    // Not implemented
+    ErrorCode(const ErrorCode&); // = delete;
+    ErrorCode& operator=(const ErrorCode&); // = delete;
+};
+
+} // namespace myo
@@ -0,0 +1,58 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <cstddef>
+
+#include "Quaternion.hpp"
+#include "QuaternionArray.hpp"
+
+namespace myo {
+
+/// The roll, pitch and yaw of a rotation, in radians.
+/// Roll is the rotation about the x axis and yaw the rotation about the z axis, both in [-pi, pi]; pitch is the
+/// rotation about the y axis, in [-pi / 2, pi / 2].
+struct EulerAngles {
+    float roll;
+    float pitch;
+    float yaw;
+};
+
+/// The roll, pitch and yaw of a rotation, each quantized to a number of equal steps.
+/// @see toEulerBuckets()
+struct EulerBuckets {
+    int roll;
+    int pitch;
+    int yaw;
+};
+
+// The conversions below evaluate the arctangent with a polynomial rather than calling atan2 and asin. The polynomial
+// is accurate to 4e-8 radians, and results are within 1e-6 radians of std::atan2 and std::asin applied to the same
+// float arguments. Batches are converted with the instruction set level returned by simdLevel(); the AVX2 path
+// computes the arguments with fused multiply-adds, so near gimbal lock, where the angles are ill-conditioned, it can
+// differ from the other paths by more than that.
+
+/// Return the Euler angles of the rotation represented by unit quaternion \a quat.
+/// \relates myo::EulerAngles
+EulerAngles toEuler(const Quaternion<float>& quat);
+
+/// Store the Euler angles of \a quats[i] in \a roll[i], \a pitch[i] and \a yaw[i] for every i. The output arrays
+/// must hold quats.size() elements each.
+/// \relates myo::EulerAngles
+void toEuler(const QuaternionArray& quats, float* roll, float* pitch, float* yaw);
+
+/// Return the Euler angles of the rotation represented by unit quaternion \a quat, each mapped onto \a buckets equal
+/// steps numbered from 0 to buckets - 1. Roll and yaw are divided over [-pi, pi] and pitch over [-pi / 2, pi / 2].
+/// Throws an exception of type std::invalid_argument if \a buckets is smaller than 1.
+/// \relates myo::EulerBuckets
+EulerBuckets toEulerBuckets(const Quaternion<float>& quat, int buckets);
+
+/// Store the quantized Euler angles of \a quats[i] in \a roll[i], \a pitch[i] and \a yaw[i] for every i. The output
+/// arrays must hold quats.size() elements each.
+/// Throws an exception of type std::invalid_argument if \a buckets is smaller than 1.
+/// \relates myo::EulerBuckets
+void toEulerBuckets(const QuaternionArray& quats, int buckets, int* roll, int* pitch, int* yaw);
+
+} // namespace myo
+
+#include "impl/EulerAngles_impl.hpp"
@@ -0,0 +1,102 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "DeviceEvent.hpp"
+
+namespace myo {
+
+/// One event read back from an event log.
+struct EventRecord {
+    uint32_t device;     ///< Index of the device within the log, in order of first appearance.
+    uint64_t macAddress; ///< MAC address of the device.
+    DeviceEvent event;   ///< The event. \a event.myo is always null.
+};
+
+/// Writes device events to a compact binary log.
+///
+/// A log starts with an 8 byte signature followed by a sequence of records. Each record starts with a one byte tag.
+/// A tag of 0xff declares the next device: a flags byte (bit 0 set if the device's first event is a pairing) and its
+/// 64 bit little-endian MAC address. Any other tag is a libmyo_event_type_t and is followed by the device index and
+/// the signed difference from the previous event's timestamp, both as LEB128 varints, then the payload for that
+/// type with multi-byte values in little-endian order. An EMG event therefore takes around 12 bytes.
+class EventLogWriter {
+public:
+    /// Create or truncate the log at \a path.
+    /// Throws an exception of type std::runtime_error if the file cannot be opened.
+    explicit EventLogWriter(const std::string& path);
+
+    /// Flush and close the log.
+    ~EventLogWriter();
+
+    /// Declare a new device with the given MAC address and return its index.
+    /// If \a paired is false, readers synthesize a libmyo_event_paired event for the device, since Hub ignores
+    /// events from devices it has not seen pair.
+    uint32_t addDevice(uint64_t macAddress, bool paired);
+
+    /// Append \a event, which belongs to the device with index \a device.
+    void write(uint32_t device, const DeviceEvent& event);
+
+    /// Flush buffered records to disk.
+    void flush();
+
+private:
+    void putByte(unsigned char byte) { _buffer.push_back(byte); }
+    void putVarint(uint64_t value);
+    void putU32(uint32_t value);
+    void putU64(uint64_t value);
+    void putFloat(float value);
+
+    std::FILE* _file;
+    std::vector<unsigned char> _buffer;
+    uint32_t _devices;
+    uint64_t _lastTimestamp;
+
+    // Not implemented
+    EventLogWriter(const EventLogWriter&); // = delete;
+    EventLogWriter& operator=(const EventLogWriter&); // = delete;
+};
+
+/// Reads events back from a log written by EventLogWriter.
+class EventLogReader {
+public:
+    /// Open the log at \a path.
+    /// Throws an exception of type std::runtime_error if the file cannot be opened or is not an event log.
+    explicit EventLogReader(const std::string& path);
+
+    /// Close the log.
+    ~EventLogReader();
+
+    /// Read the next event into \a out. Return false once the end of the log has been reached.
+    /// Throws an exception of type std::runtime_error if the log is truncated or malformed.
+    bool next(EventRecord& out);
+
+    /// Return the MAC addresses of the devices declared so far, indexed by device.
+    const std::vector<uint64_t>& devices() const { return _devices; }
+
+private:
+    unsigned char readByte();
+    uint64_t readVarint();
+    uint32_t readU32();
+    uint64_t readU64();
+    float readFloat();
+
+    std::FILE* _file;
+    std::vector<uint64_t> _devices;
+    std::vector<uint32_t> _pendingPairs;
+    uint64_t _lastTimestamp;
+
+    // Not implemented
+    EventLogReader(const EventLogReader&); // = delete;
+    EventLogReader& operator=(const EventLogReader&); // = delete;
+};
+
+} // namespace myo
+
+#include "impl/EventLog_impl.hpp"
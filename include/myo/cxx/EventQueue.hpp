@@ -0,0 +1,97 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+// EventQueue requires C++11 atomics and is therefore not included by myo.hpp; include this header explicitly.
+
+#include <stdint.h>
+
+#include <atomic>
+#include <cstddef>
+
+#include "DeviceEvent.hpp"
+#include "Hub.hpp"
+#include "detail/SpscRing.hpp"
+
+namespace myo {
+
+/// A bounded, lock-free single-producer/single-consumer queue of decoded device events.
+/// Install an EventQueue on a Hub with Hub::setEventSink() to move listener work off the thread that calls
+/// Hub::run(): that thread becomes the producer, and one other thread consumes events with pop() or dispatchTo().
+/// When the queue is full, new events are dropped rather than blocking the event loop; dropped(), overruns() and
+/// highWaterMark() report how close the queue came to its capacity so that it can be sized for the event rate.
+class EventQueue : public DeviceEventSink {
+public:
+    /// Construct a queue holding up to \a capacity events. \a capacity is rounded up to a power of two.
+    explicit EventQueue(std::size_t capacity = 1024)
+    : _ring(capacity)
+    , _overruns(0)
+    , _highWaterMark(0)
+    , _full(false)
+    {
+    }
+
+    /// Append \a event to the queue. Must only be called from the producer thread.
+    /// Return false, and count the event as dropped, if the queue is full.
+    bool push(const DeviceEvent& event)
+    {
+        std::size_t size;
+        if (!_ring.push(event, size)) {
+            if (!_full) {
+                _full = true;
+                _overruns.store(_overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+            return false;
+        }
+
+        _full = false;
+        if (size > _highWaterMark.load(std::memory_order_relaxed)) {
+            _highWaterMark.store(size, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    /// Move up to \a maxEvents of the oldest events into \a out. Must only be called from the consumer thread.
+    /// Return the number of events written to \a out.
+    std::size_t pop(DeviceEvent* out, std::size_t maxEvents)
+    {
+        return _ring.consume([&out](const DeviceEvent& event) { *out++ = event; }, maxEvents);
+    }
+
+    /// Deliver up to \a maxEvents queued events to the listeners of \a hub with Hub::dispatch(). Must only be called
+    /// from the consumer thread. Return the number of events delivered.
+    std::size_t dispatchTo(Hub& hub, std::size_t maxEvents = static_cast<std::size_t>(-1))
+    {
+        // Events are dispatched in place; the slots are only released to the producer once the batch is done.
+        return _ring.consume([&hub](const DeviceEvent& event) { hub.dispatch(event); }, maxEvents);
+    }
+
+    /// Return the maximum number of events the queue can hold.
+    std::size_t capacity() const { return _ring.capacity(); }
+
+    /// Return the number of events currently waiting in the queue. The value may be stale by the time it is used.
+    std::size_t size() const { return _ring.size(); }
+
+    /// Return the number of events that were discarded because the queue was full.
+    uint64_t dropped() const { return _ring.dropped(); }
+
+    /// Return the number of times the queue became full, i.e. the number of distinct runs of dropped events.
+    uint64_t overruns() const { return _overruns.load(std::memory_order_relaxed); }
+
+    /// Return the largest number of events that were ever waiting in the queue at once.
+    std::size_t highWaterMark() const { return _highWaterMark.load(std::memory_order_relaxed); }
+
+private:
+    SpscRing<DeviceEvent> _ring;
+
+    // Written by the producer only.
+    std::atomic<uint64_t> _overruns;
+    std::atomic<std::size_t> _highWaterMark;
+    bool _full;
+
+    // Not implemented
+    EventQueue(const EventQueue&); // = delete;
+    EventQueue& operator=(const EventQueue&); // = delete;
+};
+
+} // namespace myo
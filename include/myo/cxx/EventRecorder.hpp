@@ -0,0 +1,182 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <string>
+
+#include "DeviceEvent.hpp"
+#include "DeviceListener.hpp"
+#include "EventLog.hpp"
+#include "Myo.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+#include "detail/MyoTracks.hpp"
+
+namespace myo {
+
+/// A DeviceListener that writes every event it receives to an event log.
+/// The log can be played back through Hub on any platform with the replay implementation of libmyo found in the
+/// replay directory of the SDK.
+/// @see EventLogWriter for a description of the format.
+class EventRecorder : public DeviceListener {
+public:
+    /// Create or truncate the log at \a path.
+    /// Throws an exception of type std::runtime_error if the file cannot be opened.
+    explicit EventRecorder(const std::string& path)
+    : _log(path)
+    , _devices()
+    , _imu()
+    {
+    }
+
+    /// Flush buffered events to disk.
+    void flush() { _log.flush(); }
+
+    void onPair(Myo* myo, uint64_t timestamp, FirmwareVersion firmwareVersion)
+    {
+        DeviceEvent event = makeEvent(libmyo_event_paired, myo, timestamp);
+        event.firmwareVersion = firmwareVersion;
+        record(event);
+    }
+
+    void onUnpair(Myo* myo, uint64_t timestamp)
+    {
+        record(makeEvent(libmyo_event_unpaired, myo, timestamp));
+    }
+
+    void onConnect(Myo* myo, uint64_t timestamp, FirmwareVersion firmwareVersion)
+    {
+        DeviceEvent event = makeEvent(libmyo_event_connected, myo, timestamp);
+        event.firmwareVersion = firmwareVersion;
+        record(event);
+    }
+
+    void onDisconnect(Myo* myo, uint64_t timestamp)
+    {
+        record(makeEvent(libmyo_event_disconnected, myo, timestamp));
+    }
+
+    void onArmSync(Myo* myo, uint64_t timestamp, Arm arm, XDirection xDirection, float rotation,
+                   WarmupState warmupState)
+    {
+        DeviceEvent event = makeEvent(libmyo_event_arm_synced, myo, timestamp);
+        event.armSync.arm = arm;
+        event.armSync.xDirection = xDirection;
+        event.armSync.rotation = rotation;
+        event.armSync.warmupState = warmupState;
+        record(event);
+    }
+
+    void onArmUnsync(Myo* myo, uint64_t timestamp)
+    {
+        record(makeEvent(libmyo_event_arm_unsynced, myo, timestamp));
+    }
+
+    void onUnlock(Myo* myo, uint64_t timestamp)
+    {
+        record(makeEvent(libmyo_event_unlocked, myo, timestamp));
+    }
+
+    void onLock(Myo* myo, uint64_t timestamp)
+    {
+        record(makeEvent(libmyo_event_locked, myo, timestamp));
+    }
+
+    void onPose(Myo* myo, uint64_t timestamp, Pose pose)
+    {
+        DeviceEvent event = makeEvent(libmyo_event_pose, myo, timestamp);
+        event.pose = pose.type();
+        record(event);
+    }
+
+    // A single libmyo orientation event is delivered as onOrientationData(), onAccelerometerData() and
+    // onGyroscopeData(), in that order. The first two are buffered and the event is written out by the last.
+
+    void onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation)
+    {
+        _imu.orientation[0] = rotation.x();
+        _imu.orientation[1] = rotation.y();
+        _imu.orientation[2] = rotation.z();
+        _imu.orientation[3] = rotation.w();
+    }
+
+    void onAccelerometerData(Myo* myo, uint64_t timestamp, const Vector3<float>& accel)
+    {
+        for (unsigned int i = 0; i < 3; ++i) {
+            _imu.accelerometer[i] = accel[i];
+        }
+    }
+
+    void onGyroscopeData(Myo* myo, uint64_t timestamp, const Vector3<float>& gyro)
+    {
+        DeviceEvent event = makeEvent(libmyo_event_orientation, myo, timestamp);
+        event.imu = _imu;
+        for (unsigned int i = 0; i < 3; ++i) {
+            event.imu.gyroscope[i] = gyro[i];
+        }
+        record(event);
+    }
+
+    void onRssi(Myo* myo, uint64_t timestamp, int8_t rssi)
+    {
+        DeviceEvent event = makeEvent(libmyo_event_rssi, myo, timestamp);
+        event.rssi = rssi;
+        record(event);
+    }
+
+    void onBatteryLevelReceived(Myo* myo, uint64_t timestamp, uint8_t level)
+    {
+        DeviceEvent event = makeEvent(libmyo_event_battery_level, myo, timestamp);
+        event.batteryLevel = level;
+        record(event);
+    }
+
+    void onEmgData(Myo* myo, uint64_t timestamp, const int8_t* emg)
+    {
+        DeviceEvent event = makeEvent(libmyo_event_emg, myo, timestamp);
+        for (unsigned int i = 0; i < 8; ++i) {
+            event.emg[i] = emg[i];
+        }
+        record(event);
+    }
+
+    void onWarmupCompleted(Myo* myo, uint64_t timestamp, WarmupResult warmupResult)
+    {
+        DeviceEvent event = makeEvent(libmyo_event_warmup_completed, myo, timestamp);
+        event.warmupResult = warmupResult;
+        record(event);
+    }
+
+private:
+    static DeviceEvent makeEvent(libmyo_event_type_t type, Myo* myo, uint64_t timestamp)
+    {
+        DeviceEvent event;
+        event.type = type;
+        event.timestamp = timestamp;
+        event.myo = myo;
+        return event;
+    }
+
+    void record(const DeviceEvent& event)
+    {
+        _log.write(deviceIndex(event.myo, event.type == libmyo_event_paired), event);
+    }
+
+    uint32_t deviceIndex(Myo* myo, bool pairing)
+    {
+        uint32_t* device = _devices.find(myo);
+        if (!device) {
+            uint64_t macAddress = libmyo_get_mac_address(myo->libmyoObject());
+            uint32_t added = _log.addDevice(macAddress, pairing);
+            device = &_devices.get(myo);
+            *device = added;
+        }
+        return *device;
+    }
+
+    EventLogWriter _log;
+    MyoTracks<uint32_t> _devices;
+    DeviceEvent::Imu _imu;
+};
+
+} // namespace myo
@@ -0,0 +1,84 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "EulerAngles.hpp"
+
+namespace myo {
+
+/// Recognizes gestures in a stream of orientations by comparing the most recent samples against a set of templates.
+///
+/// Templates and the stream are compared relative to their first sample, so a gesture matches regardless of the
+/// orientation it starts from. Similarity is measured with dynamic time warping constrained to a band around the
+/// diagonal, so that a gesture performed somewhat faster or slower than its template still matches. To keep the cost
+/// per sample low with many templates, each template is first checked against the LB_Keogh lower bound computed
+/// from its envelope, and the warping itself is abandoned as soon as it cannot beat the best match found so far.
+///
+/// GestureMatcher does not receive events itself; feed it from a DeviceListener's onOrientationData(), one instance
+/// per Myo.
+class GestureMatcher {
+public:
+    /// The result of a successful update().
+    struct Match {
+        std::size_t templateIndex; ///< Index of the matching template, as returned by addTemplate().
+        float distance;            ///< Warping distance per sample, in squared radians.
+    };
+
+    /// Create a matcher without templates.
+    /// A template matches when its warping distance per sample is below \a threshold, in squared radians. \a band is
+    /// the width of the warping band as a fraction of the template length.
+    explicit GestureMatcher(float threshold = 0.05f, float band = 0.1f);
+
+    /// Add a template and return its index.
+    /// Throws an exception of type std::invalid_argument if \a samples holds fewer than two samples.
+    std::size_t addTemplate(const std::vector<EulerAngles>& samples);
+
+    /// Return the number of templates.
+    std::size_t templateCount() const { return _templates.size(); }
+
+    /// Remove all templates and forget the stream.
+    void clearTemplates();
+
+    /// Forget the stream, for example when the Myo has been disconnected.
+    void reset();
+
+    /// Append \a angles to the stream and compare the stream against every template.
+    /// Return true and fill in \a match with the closest template if any template matches. After a match the stream
+    /// is forgotten, so that the same gesture is not reported again on the following samples.
+    bool update(const EulerAngles& angles, Match& match);
+
+private:
+    struct Template {
+        std::size_t length;
+        std::size_t band;
+        std::vector<float> values; // length * 3 values, relative to the first sample.
+        std::vector<float> upper;  // Largest value within the band around each sample.
+        std::vector<float> lower;  // Smallest value within the band around each sample.
+    };
+
+    static float wrapAngle(float angle);
+    static void relativeAngles(const EulerAngles& sample, const EulerAngles& first, float* values);
+    float lowerBound(const Template& pattern, std::size_t start, float bound) const;
+    void buildCandidate(std::size_t start, std::size_t length);
+    float warpingDistance(const Template& pattern, float bound);
+
+    float _threshold;
+    float _band;
+    std::vector<Template> _templates;
+    std::size_t _maxLength;
+
+    std::vector<EulerAngles> _history; // A ring of the last _maxLength samples.
+    std::size_t _historyEnd;
+    std::size_t _historySize;
+
+    std::vector<float> _candidate;     // The stream relative to its first sample, as for Template::values, built
+                                       // only for templates that pass the lower bound.
+    std::vector<float> _rows;          // Two rows of the warping cost matrix.
+};
+
+} // namespace myo
+
+#include "impl/GestureMatcher_impl.hpp"
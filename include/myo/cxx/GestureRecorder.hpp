@@ -0,0 +1,95 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "DeviceListener.hpp"
+#include "EulerAngles.hpp"
+#include "Quaternion.hpp"
+#include "detail/MyoTracks.hpp"
+
+namespace myo {
+
+class Myo;
+
+/// One movement of the arm between two resting orientations.
+struct GestureMovement {
+    uint64_t startTimestamp; ///< Timestamp of the orientation sample at which the movement was detected.
+    uint64_t endTimestamp;   ///< Timestamp of the orientation sample at which the arm came to rest.
+    EulerAngles change;      ///< Change of roll, pitch and yaw from the previous rest to this one, in radians.
+};
+
+/// A sequence of movements recorded by GestureRecorder.
+struct Gesture {
+    std::vector<GestureMovement> movements;
+
+    /// The orientation at every sample from the start of the first movement to the end of the last, including any
+    /// rest between movements. This can be added to a GestureMatcher as a template.
+    std::vector<EulerAngles> samples;
+};
+
+/// A DeviceListener that splits the orientation stream of each Myo into movements and groups them into gestures.
+///
+/// Segmentation runs incrementally on every orientation sample, so recording never blocks the event loop. A movement
+/// starts on the first sample whose roll, pitch or yaw differs from the resting orientation by more than the start
+/// angle, and ends once the angular speed has stayed below the stop speed for the settle time. Every
+/// \a movementsPerGesture movements form a gesture. A gesture whose next movement does not start within the rest
+/// timeout of the previous one ending is discarded, so that an arm left resting halfway through a gesture does not
+/// keep adding samples to it.
+class GestureRecorder : public DeviceListener {
+public:
+    /// Create a recorder with the given thresholds.
+    /// \a startAngle is in radians, \a stopSpeed in radians per second, and \a settleTime and \a restTimeout in
+    /// microseconds.
+    explicit GestureRecorder(std::size_t movementsPerGesture = 3, float startAngle = 0.5f, float stopSpeed = 0.35f,
+                             uint64_t settleTime = 100000, uint64_t restTimeout = 2000000);
+
+    /// Discard partially recorded gestures and take the next orientation of each Myo as its resting orientation.
+    void reset();
+
+    /// Return true if a movement of \a myo is in progress.
+    bool isMoving(Myo* myo) const;
+
+    /// Called when a movement of \a myo has ended.
+    virtual void onMovement(Myo* myo, uint64_t timestamp, const GestureMovement& movement) {}
+
+    /// Called when the last movement of a gesture of \a myo has ended.
+    virtual void onGesture(Myo* myo, uint64_t timestamp, const Gesture& gesture) {}
+
+    void onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation);
+    void onDisconnect(Myo* myo, uint64_t timestamp);
+    void onUnpair(Myo* myo, uint64_t timestamp);
+
+private:
+    enum State {
+        stateIdle,   // No orientation received yet.
+        stateResting,
+        stateMoving
+    };
+
+    struct Track {
+        State state;
+        EulerAngles rest;
+        EulerAngles last;
+        uint64_t lastTimestamp;
+        uint64_t stillSince;
+        GestureMovement movement;
+        Gesture gesture;
+    };
+
+    static EulerAngles angleChange(const EulerAngles& from, const EulerAngles& to);
+    static float largestAngle(const EulerAngles& angles);
+
+    std::size_t _movementsPerGesture;
+    float _startAngle;
+    float _stopSpeed;
+    uint64_t _settleTime;
+    uint64_t _restTimeout;
+    MyoTracks<Track> _tracks;
+};
+
+} // namespace myo
+
+#include "impl/GestureRecorder_impl.hpp"
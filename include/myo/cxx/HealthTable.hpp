@@ -0,0 +1,119 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+// HealthTable requires C++11 atomics and is therefore not included by myo.hpp; include this header explicitly.
+
+#include <stdint.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "DeviceHealth.hpp"
+
+namespace myo {
+
+/// A table of the DeviceHealth records of the Myos of a Hub that any number of threads can read without locks while
+/// the thread running the Hub keeps it up to date. Install it with Hub::setHealthSink().
+///
+/// Each record is guarded by a sequence number that the writer makes odd while it copies the record in. A reader
+/// retries a read that overlapped a write, so it never sees a torn record, and the event loop never waits for
+/// readers. Records are indexed by the position of their Myo in the Hub's list of Myos; a Myo's MAC address is part
+/// of its record.
+class HealthTable : public DeviceHealthSink {
+public:
+    /// Construct a table with room for the records of \a capacity Myos.
+    explicit HealthTable(std::size_t capacity = 64)
+    : _slots(capacity)
+    , _size(0)
+    , _overflows(0)
+    {
+    }
+
+    /// Return the number of Myos the table has room for.
+    std::size_t capacity() const { return _slots.size(); }
+
+    /// Return the number of records written so far: one more than the highest index written.
+    std::size_t size() const { return _size.load(std::memory_order_acquire); }
+
+    /// Copy the record at \a index into \a health. May be called from any thread.
+    /// Return false if no record has been written at \a index.
+    bool read(std::size_t index, DeviceHealth& health) const
+    {
+        if (index >= size()) {
+            return false;
+        }
+
+        const Slot& slot = _slots[index];
+        uint64_t words[wordCount];
+        for (;;) {
+            const uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                continue;
+            }
+            for (std::size_t i = 0; i < wordCount; ++i) {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+                break;
+            }
+        }
+
+        std::memcpy(&health, words, sizeof(health));
+        return true;
+    }
+
+    /// Return the number of records dropped because their index was beyond the capacity.
+    uint64_t overflows() const { return _overflows.load(std::memory_order_relaxed); }
+
+    /// Store \a health at \a index. Must only be called from one thread at a time, normally by the Hub.
+    void update(std::size_t index, const DeviceHealth& health)
+    {
+        if (index >= _slots.size()) {
+            _overflows.store(_overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+
+        uint64_t words[wordCount] = {};
+        std::memcpy(words, &health, sizeof(health));
+
+        Slot& slot = _slots[index];
+        const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+
+        if (index >= _size.load(std::memory_order_relaxed)) {
+            _size.store(index + 1, std::memory_order_release);
+        }
+    }
+
+private:
+    enum { wordCount = (sizeof(DeviceHealth) + sizeof(uint64_t) - 1) / sizeof(uint64_t) };
+
+    // The record is held in atomic words so that a read overlapping a write is not a data race.
+    struct Slot {
+        Slot()
+        : sequence(0)
+        {
+            for (std::size_t i = 0; i < wordCount; ++i) {
+                words[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        std::atomic<uint32_t> sequence;
+        std::atomic<uint64_t> words[wordCount];
+    };
+
+    std::vector<Slot> _slots;
+    std::atomic<std::size_t> _size;
+    std::atomic<uint64_t> _overflows;
+};
+
+} // namespace myo
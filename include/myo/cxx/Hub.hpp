@@ -2,16 +2,30 @@
 // Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
 #pragma once
 
+#include <stdint.h>
+
 #include <vector>
 
 #include <myo/libmyo.h>
 
+#include "DeviceHealth.hpp"
+#include "DeviceState.hpp"
+#include "ErrorCode.hpp"
+#include "detail/HealthPoller.hpp"
+#include "detail/MyoTable.hpp"
+#include "detail/SampleBatcher.hpp"
+
 namespace myo {
 
 class Myo;
 class DeviceListener;
+class DeviceEventSink;
+class DispatchObserver;
+struct DeviceEvent;
 
 /// @brief A Hub provides access to one or more Myo instances.
+/// Each function that calls into libmyo comes in two forms: one that throws std::invalid_argument or
+/// std::runtime_error on failure, and one that takes an ErrorCode and never throws.
 class Hub {
 public:
     /// Construct a hub.
@@ -28,21 +42,154 @@ public:
     /// because Myo Connect is not running and a connection can thus not be established.
     Hub(const std::string& applicationIdentifier = "");
 
+    /// Construct a hub, reporting failures through \a error instead of throwing.
+    /// If \a error indicates a failure, the hub is not connected to libmyo and the only valid operation on it is its
+    /// destruction.
+    Hub(const std::string& applicationIdentifier, ErrorCode& error);
+
     /// Deallocate any resources associated with a Hub.
-    /// This will cause all Myo instances retrieved from this Hub to become invalid.
+    /// This will cause all Myo instances retrieved from this Hub to become invalid. A hub whose construction failed
+    /// may be destroyed safely.
     ~Hub();
 
     /// Wait for a Myo to become paired, or time out after \a timeout_ms milliseconds if provided.
     /// If \a timeout_ms is zero, this function blocks until a Myo is found.
     /// This function must not be called concurrently with run() or runOnce().
     Myo* waitForMyo(unsigned int milliseconds = 0);
+    Myo* waitForMyo(unsigned int milliseconds, ErrorCode& error);
+
+    /// Bits selecting the event types a listener is subscribed to. Bit n stands for the libmyo_event_type_t value n,
+    /// except for eventImuBatch and eventEmgBatch, which select the batches of setBatchSize() instead.
+    enum EventMask {
+        eventPaired          = 1u << libmyo_event_paired,
+        eventUnpaired        = 1u << libmyo_event_unpaired,
+        eventConnected       = 1u << libmyo_event_connected,
+        eventDisconnected    = 1u << libmyo_event_disconnected,
+        eventArmSynced       = 1u << libmyo_event_arm_synced,
+        eventArmUnsynced     = 1u << libmyo_event_arm_unsynced,
+        eventOrientation     = 1u << libmyo_event_orientation,
+        eventPose            = 1u << libmyo_event_pose,
+        eventRssi            = 1u << libmyo_event_rssi,
+        eventUnlocked        = 1u << libmyo_event_unlocked,
+        eventLocked          = 1u << libmyo_event_locked,
+        eventEmg             = 1u << libmyo_event_emg,
+        eventBatteryLevel    = 1u << libmyo_event_battery_level,
+        eventWarmupCompleted = 1u << libmyo_event_warmup_completed,
+        eventImuBatch        = 1u << 29,
+        eventEmgBatch        = 1u << 30,
+        allEvents            = 0xffffffffu & ~(eventImuBatch | eventEmgBatch)
+    };
 
     /// Register a listener to be called when device events occur.
-    void addListener(DeviceListener* listener);
+    /// \a events is a combination of EventMask bits selecting the event types the listener is called for, including
+    /// DeviceListener::onOpaqueEvent(). eventImuBatch and eventEmgBatch select onImuBatch() and onEmgBatch(); a
+    /// listener that only wants batches should leave out eventOrientation and eventEmg so that it is not also called
+    /// for every sample. The hub only reads the payload of an event out of libmyo if some listener is subscribed to
+    /// it, so a listener that only overrides onPose() should pass eventPose. Adding a listener again replaces its
+    /// subscription.
+    void addListener(DeviceListener* listener, uint32_t events = allEvents);
 
     /// Remove a previously registered listener.
     void removeListener(DeviceListener* listener);
 
+    /// Divert decoded events to \a sink instead of calling listeners from within run() and runOnce().
+    /// This lets listeners run on a different thread than the one driving the event loop: the thread calling run()
+    /// pushes each event into \a sink, and the consuming thread hands them to the listeners with dispatch().
+    /// DeviceListener::onOpaqueEvent() is not called for diverted events. Pass null to restore direct dispatch.
+    /// This function must not be called concurrently with run() or runOnce().
+    /// @see EventQueue
+    void setEventSink(DeviceEventSink* sink);
+
+    /// Deliver a previously diverted \a event to every registered listener.
+    /// Listeners must not be added or removed while another thread is calling this function.
+    void dispatch(const DeviceEvent& event);
+
+    /// Report the progress of each event through the hub to \a observer, e.g. to measure event ages and the time
+    /// spent in each listener. Pass null, the default, to stop; the event loop then only pays for a null check.
+    /// This function must not be called concurrently with run(), runOnce() or dispatch().
+    /// @see HubProfiler
+    void setDispatchObserver(DispatchObserver* observer);
+
+    /// Accumulate EMG and IMU samples for each Myo into blocks of \a samples samples and deliver them to
+    /// DeviceListener::onEmgBatch() and DeviceListener::onImuBatch() of the listeners subscribed to eventEmgBatch and
+    /// eventImuBatch. Samples only go into batches while some listener is subscribed to them, and listeners
+    /// subscribed to eventEmg or eventOrientation alone are called for each sample as before.
+    /// Pending samples are flushed before the batch size changes and when a Myo disconnects or is unpaired.
+    /// A batch size of zero, the default, disables batching.
+    /// This function must not be called concurrently with run(), runOnce() or dispatch().
+    void setBatchSize(std::size_t samples);
+
+    /// Deliver all pending partial batches to the listeners.
+    /// This function must not be called concurrently with run(), runOnce() or dispatch().
+    void flushBatches();
+
+    /// Queue the commands sent to each Myo of this hub, such as Myo::unlock() and Myo::vibrate(), and send them from
+    /// run() and runOnce() instead, at no more than \a commandsPerSecond per Myo in bursts of at most \a burst.
+    /// Every command becomes a Bluetooth write on the link that also carries the Myo's data, so a burst of them, e.g.
+    /// from listeners reacting to rapid pose changes, would hold up the events that follow. Queued commands are
+    /// merged: a command issued again before the previous one was sent replaces it, stacked vibrations become the
+    /// longest one, and a hold unlock or EMG stream mode that is already in effect is not sent again. run() hands
+    /// libmyo slices of at most commandSliceMs milliseconds and sends what the rate allows between them. The rate is
+    /// measured against the timestamps of the events the hub receives, and against the time spent in libmyo while
+    /// none arrive, so that commands keep going out while the link is quiet. Commands to a Myo that disconnects are
+    /// dropped.
+    /// A rate of zero, the default, sends each command as it is issued. While commands are queued, they must be issued
+    /// on the thread that calls run() and runOnce().
+    /// This function must not be called concurrently with run(), runOnce() or dispatch().
+    void setCommandRate(unsigned int commandsPerSecond, unsigned int burst = 3);
+
+    /// Longest stretch, in milliseconds, that run() spends in libmyo without sending queued commands, requesting
+    /// health readings or publishing health records, when any of these is enabled.
+    enum { commandSliceMs = 10 };
+
+    /// Send the queued commands that the rate allows now; if no rate is set, send all of them.
+    /// This function must not be called concurrently with run(), runOnce() or dispatch().
+    void flushCommands();
+    void flushCommands(ErrorCode& error);
+
+    /// Request the RSSI of each connected Myo every \a rssiIntervalMs milliseconds and its battery level every
+    /// \a batteryIntervalMs milliseconds, keeping its DeviceHealth record current without polling the whole fleet at
+    /// once. Each Myo gets its own phase within an interval, and every interval is lengthened or shortened at random
+    /// by up to \a jitter times its length, so that the Myos don't fall into step. \a jitter is limited to 0.5, so
+    /// that an interval never shrinks below half its length. A request that is still unanswered when the next one is
+    /// due counts as missed. Requests are issued between the slices of run(), and go through the command queue if
+    /// setCommandRate() is in effect. An interval of zero, the default, stops that kind of request.
+    /// This function must not be called concurrently with run(), runOnce() or dispatch().
+    void setHealthPolling(unsigned int rssiIntervalMs, unsigned int batteryIntervalMs, float jitter = 0.2f);
+
+    /// Hand the DeviceHealth record of each Myo to \a sink whenever it has changed, at most once per slice of run().
+    /// Pass null, the default, to stop.
+    /// This function must not be called concurrently with run(), runOnce() or dispatch().
+    /// @see HealthTable
+    void setHealthSink(DeviceHealthSink* sink);
+
+    /// Return the DeviceHealth record of \a myo. Records are only kept up to date while health is polled or a sink
+    /// is set. This function must only be called from the thread that calls run() and runOnce(); use a HealthTable
+    /// to read records from other threads.
+    const DeviceHealth& health(const Myo* myo) const;
+
+    /// Return what is known about the state of \a myo: whether it is paired, connected, synced to an arm and
+    /// unlocked, the details of its arm sync, the configuration last requested of it, and how long it took to deliver
+    /// EMG after it last connected. The state is kept up to date from the events of the Myo whether or not any
+    /// listener is subscribed to them. This function must only be called from the thread that calls run() and
+    /// runOnce().
+    const DeviceState& state(const Myo* myo) const;
+
+    /// Choose whether the EMG streaming mode and hold unlock last requested for a Myo, which the Myo forgets when it
+    /// disconnects, are sent again as soon as it connects, ahead of any listener's onConnect(). Failures to send
+    /// them are counted in DeviceState::restoreFailures. This is on by default.
+    /// This function must not be called concurrently with run(), runOnce() or dispatch().
+    void setRestoreOnConnect(bool restore);
+
+    /// Only handle Myos whose MAC address falls into shard \a index of \a count.
+    /// Every hub connected to Myo Connect sees every paired Myo. Giving several hubs the same \a count and distinct
+    /// indices splits the Myos between them, so that each hub's event loop only decodes and dispatches events for its
+    /// own share; events of other Myos are discarded after a single table lookup. A count of one, the default,
+    /// handles every Myo. This function must be called before any Myo is paired, i.e. before the first call to
+    /// waitForMyo(), run() or runOnce().
+    /// @see HubGroup
+    void setShard(std::size_t index, std::size_t count);
+
     /// Locking policies supported by Myo.
     enum LockingPolicy {
         lockingPolicyNone     = libmyo_locking_policy_none,
@@ -51,12 +198,15 @@ public:
 
     /// Set the locking policy for Myos connected to the Hub.
     void setLockingPolicy(LockingPolicy lockingPolicy);
+    void setLockingPolicy(LockingPolicy lockingPolicy, ErrorCode& error);
 
     /// Run the event loop for the specified duration (in milliseconds).
     void run(unsigned int duration_ms);
+    void run(unsigned int duration_ms, ErrorCode& error);
 
     /// Run the event loop until a single event occurs, or the specified duration (in milliseconds) has elapsed.
     void runOnce(unsigned int duration_ms);
+    void runOnce(unsigned int duration_ms, ErrorCode& error);
 
     /// @cond MYO_INTERNALS
 
@@ -70,9 +220,60 @@ protected:
 
     Myo* addMyo(libmyo_myo_t opaqueMyo);
 
+    bool ownsMyo(libmyo_myo_t opaqueMyo) const;
+
+    bool batchesEvent(uint32_t type) const;
+
+    bool tracksPayload(uint32_t type) const;
+
+    void batchEvent(const DeviceEvent& event);
+
+    void flushBatch(SampleBatcher& batcher);
+
+    void trackEvent(Myo* myo, const DeviceEvent& event);
+
+    void serviceMyos(ErrorCode& error);
+
+    void advanceClock(uint64_t timestamp);
+
+    void creditIdleTime(uint64_t lastTimestamp, unsigned int duration_ms);
+
+    void trackState(Myo* myo, const DeviceEvent& event);
+
+    void restoreState(Myo* myo);
+
+    const std::vector<DeviceListener*>& eventListeners(uint32_t type) const;
+
+    void updateEventListeners();
+
     libmyo_hub_t _hub;
     std::vector<Myo*> _myos;
+    MyoTable _myoTable;
+    ObjectPool<Myo> _myoPool;
     std::vector<DeviceListener*> _listeners;
+    std::vector<uint32_t> _listenerEvents;
+
+    // Listeners subscribed to each event type, in the order they were added. The slots of the batch bits, which no
+    // libmyo event type reaches, hold the listeners subscribed to batches.
+    enum { eventTypeSlots = 32, imuBatchSlot = 29, emgBatchSlot = 30 };
+    std::vector<DeviceListener*> _eventListeners[eventTypeSlots];
+
+    DeviceEventSink* _eventSink;
+    DispatchObserver* _observer;
+    std::size_t _batchSize;
+    std::vector<SampleBatcher> _batchers;
+    unsigned int _commandRate;
+    unsigned int _commandBurst;
+    HealthPoller _health;
+    DeviceHealthSink* _healthSink;
+    bool _restoreOnConnect;
+    // Microseconds, advanced by event timestamps and, while no events arrive, by the time run() spends in libmyo,
+    // while commands are queued or health is tracked.
+    uint64_t _clock;
+    uint64_t _lastTimestamp; // Latest event timestamp.
+    uint64_t _idleCredit;    // Time added to _clock since the latest event, not yet covered by event timestamps.
+    std::size_t _shardIndex;
+    std::size_t _shardCount;
 
     /// @endcond
 
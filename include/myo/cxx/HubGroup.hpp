@@ -0,0 +1,302 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+// HubGroup requires C++11 threads and atomics and is therefore not included by myo.hpp; include this header
+// explicitly.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+# include "detail/Windows.hpp"
+#elif defined(__linux__)
+# include <pthread.h>
+# include <sched.h>
+#endif
+
+#include "DeviceListener.hpp"
+#include "ErrorCode.hpp"
+#include "Hub.hpp"
+#include "detail/SpscRing.hpp"
+
+namespace myo {
+
+/// Runs several hubs on a pool of worker threads and splits the paired Myos between them by MAC address.
+///
+/// Each worker thread owns one Hub, set up with Hub::setShard() so that it only handles its share of the Myos, and
+/// its own set of listeners, which are only ever called on that thread. Listeners hand their results to the rest of
+/// the application by posting values of type \a Result to their shard; each shard has a lock-free
+/// single-producer/single-consumer queue, and one consumer thread merges the queues with drain().
+template<typename Result>
+class HubGroup {
+public:
+    /// The state of one worker thread, passed to the setup function on that thread.
+    class Shard {
+    public:
+        /// Return the hub run by this shard.
+        Hub& hub() { return *_hub; }
+
+        /// Return the position of this shard within the group.
+        std::size_t index() const { return _index; }
+
+        /// Register \a listener with the hub of this shard for \a events and keep it alive until the group stops.
+        /// @see Hub::addListener()
+        template<typename Listener>
+        Listener& addListener(std::unique_ptr<Listener> listener, uint32_t events = Hub::allEvents)
+        {
+            Listener& result = *listener;
+            _hub->addListener(listener.get(), events);
+            _listeners.push_back(std::unique_ptr<DeviceListener>(listener.release()));
+            return result;
+        }
+
+        /// Queue \a result for HubGroup::drain(). Must only be called on this shard's thread, i.e. from the setup
+        /// function or from its listeners. Return false, and count the result as dropped, if the queue is full.
+        bool post(const Result& result) { return _results.push(result); }
+
+    private:
+        Shard(std::size_t index, std::size_t queueCapacity)
+        : _index(index)
+        , _hub()
+        , _listeners()
+        , _results(queueCapacity)
+        , _thread()
+        , _error()
+        {
+        }
+
+        std::size_t _index;
+        std::unique_ptr<Hub> _hub;
+        std::vector<std::unique_ptr<DeviceListener>> _listeners;
+        SpscRing<Result> _results;
+        std::thread _thread;
+        std::string _error;
+
+        friend class HubGroup;
+    };
+
+    /// Called on each worker thread after its hub has been created, to register listeners and configure the hub.
+    typedef std::function<void(Shard&)> Setup;
+
+    /// Create a group of \a shards hubs for \a applicationIdentifier, each queuing up to \a queueCapacity results.
+    /// Nothing is started until start() is called.
+    HubGroup(const std::string& applicationIdentifier, std::size_t shards, std::size_t queueCapacity = 4096)
+    : _applicationIdentifier(applicationIdentifier)
+    , _shards()
+    , _stopping(false)
+    , _running(false)
+    , _sliceMs(10)
+    , _mutex()
+    , _started()
+    , _startedCount(0)
+    , _startError()
+    {
+        if (shards == 0) {
+            throw std::invalid_argument("A HubGroup needs at least one shard");
+        }
+        for (std::size_t i = 0; i < shards; ++i) {
+            _shards.push_back(std::unique_ptr<Shard>(new Shard(i, queueCapacity)));
+        }
+    }
+
+    /// Stop the worker threads if they are running.
+    ~HubGroup()
+    {
+        stop();
+    }
+
+    /// Start one worker thread per shard. Each thread creates its hub, calls \a setup and then runs the hub's event
+    /// loop in slices of \a sliceMs milliseconds until stop() is called. If \a pinThreads is true, shard i is pinned
+    /// to processor i modulo the number of processors, on platforms that support it.
+    /// Return once every hub has been created and set up.
+    /// Throws an exception of type std::runtime_error, after stopping the other threads, if any hub fails to
+    /// initialize or its setup function throws.
+    void start(const Setup& setup, bool pinThreads = true, unsigned int sliceMs = 10)
+    {
+        if (_running) {
+            return;
+        }
+
+        _stopping.store(false);
+        _sliceMs = sliceMs;
+        _startedCount = 0;
+        _startError.clear();
+
+        unsigned int processors = std::thread::hardware_concurrency();
+        for (std::size_t i = 0; i < _shards.size(); ++i) {
+            Shard* shard = _shards[i].get();
+            shard->_error.clear();
+            int processor = pinThreads && processors ? static_cast<int>(i % processors) : -1;
+            shard->_thread = std::thread(&HubGroup::work, this, shard, setup, processor);
+        }
+        _running = true;
+
+        std::string error;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _started.wait(lock, [this] { return _startedCount == _shards.size(); });
+            error = _startError;
+        }
+
+        if (!error.empty()) {
+            stop();
+            throw std::runtime_error(error);
+        }
+    }
+
+    /// Ask every worker thread to finish its current slice and wait for them. Hubs and the listeners added through
+    /// Shard::addListener() are destroyed; results that have not been drained are kept.
+    void stop()
+    {
+        if (!_running) {
+            return;
+        }
+
+        _stopping.store(true);
+        for (std::size_t i = 0; i < _shards.size(); ++i) {
+            if (_shards[i]->_thread.joinable()) {
+                _shards[i]->_thread.join();
+            }
+        }
+        _running = false;
+    }
+
+    /// Return true between start() and stop().
+    bool running() const { return _running; }
+
+    /// Return the number of shards.
+    std::size_t shardCount() const { return _shards.size(); }
+
+    /// Return the error that stopped shard \a index, or an empty string: a libmyo failure, or the message of an
+    /// exception thrown on its thread by the hub, the setup function or a listener. The other shards keep running.
+    /// Only valid once the group has stopped.
+    const std::string& error(std::size_t index) const { return _shards[index]->_error; }
+
+    /// Call \a consumer with every result queued so far, shard by shard. Results of one shard are delivered in the
+    /// order they were posted. Must only be called from one thread at a time. Return the number of results delivered.
+    template<typename Consumer>
+    std::size_t drain(Consumer consumer)
+    {
+        std::size_t count = 0;
+        Result result;
+        for (std::size_t i = 0; i < _shards.size(); ++i) {
+            while (_shards[i]->_results.pop(result)) {
+                consumer(result);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /// Return the number of results discarded because a shard's queue was full.
+    uint64_t dropped() const
+    {
+        uint64_t count = 0;
+        for (std::size_t i = 0; i < _shards.size(); ++i) {
+            count += _shards[i]->_results.dropped();
+        }
+        return count;
+    }
+
+private:
+    static void pinCurrentThread(int processor)
+    {
+        if (processor < 0) {
+            return;
+        }
+#if defined(_WIN32)
+        SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << processor);
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(processor, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+    }
+
+    // Record \a exception, thrown on the thread of \a shard, as the error that stopped it.
+    static void fail(Shard* shard, std::exception_ptr exception)
+    {
+        try {
+            std::rethrow_exception(exception);
+        } catch (const std::exception& e) {
+            shard->_error = *e.what() ? e.what() : "Exception without a message";
+        } catch (...) {
+            shard->_error = "Exception of unknown type";
+        }
+    }
+
+    void work(Shard* shard, Setup setup, int processor)
+    {
+        pinCurrentThread(processor);
+
+        // Nothing may escape this thread, or std::terminate() would take down every shard. Whatever is thrown while
+        // creating the hub, setting it up or running its listeners stops this shard only and becomes its error.
+        try {
+            ErrorCode error;
+            shard->_hub.reset(new Hub(_applicationIdentifier, error));
+            if (!error.failed()) {
+                shard->_hub->setShard(shard->_index, _shards.size());
+                setup(*shard);
+            } else {
+                shard->_error = error.message();
+            }
+        } catch (...) {
+            fail(shard, std::current_exception());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_startedCount;
+            // Shards that started may already be running and updating their own errors, so start() is only told
+            // about failures to start.
+            if (_startError.empty()) {
+                _startError = shard->_error;
+            }
+        }
+        _started.notify_all();
+
+        try {
+            ErrorCode error;
+            while (shard->_error.empty() && !_stopping.load(std::memory_order_relaxed)) {
+                shard->_hub->run(_sliceMs, error);
+                if (error.failed()) {
+                    shard->_error = error.message();
+                }
+            }
+        } catch (...) {
+            fail(shard, std::current_exception());
+        }
+
+        // Listeners may refer to the hub's Myos, so they go first.
+        shard->_listeners.clear();
+        shard->_hub.reset();
+    }
+
+    std::string _applicationIdentifier;
+    std::vector<std::unique_ptr<Shard>> _shards;
+    std::atomic<bool> _stopping;
+    bool _running;
+    unsigned int _sliceMs;
+
+    std::mutex _mutex;
+    std::condition_variable _started;
+    std::size_t _startedCount;
+    std::string _startError; // The first error of a shard that failed to start.
+
+    // Not implemented
+    HubGroup(const HubGroup&); // = delete;
+    HubGroup& operator=(const HubGroup&); // = delete;
+};
+
+} // namespace myo
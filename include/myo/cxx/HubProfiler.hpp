@@ -0,0 +1,345 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+// HubProfiler requires C++11 atomics and clocks and is therefore not included by myo.hpp; include this header
+// explicitly.
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "DispatchObserver.hpp"
+
+namespace myo {
+
+class DeviceListener;
+
+/// Percentiles and extremes of a LatencyHistogram, in nanoseconds.
+/// Percentiles are the largest value of the bucket they fall into, so they overstate the true value by at most an
+/// eighth.
+struct LatencySummary {
+    uint64_t count;
+    uint64_t min;
+    uint64_t mean;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+};
+
+/// A histogram of durations with logarithmic buckets, in the style of HdrHistogram: every power of two is split
+/// into 8 buckets, so any value from 1 ns to 2 minutes is recorded with a relative error below 12.5% in a fixed
+/// 280 buckets. Recording is a few arithmetic operations and relaxed atomic stores.
+/// record() must only be called from one thread at a time; summary() may be called concurrently from any thread,
+/// and sees each recorded value either entirely or not at all.
+class LatencyHistogram {
+public:
+    /// Number of buckets; larger values are counted in the last one.
+    enum { bucketCount = 280 };
+
+    LatencyHistogram()
+    {
+        reset();
+    }
+
+    /// Count \a value.
+    void record(uint64_t value)
+    {
+        std::atomic<uint64_t>& bucket = _buckets[bucketOf(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        _sum.store(_sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value < _min.load(std::memory_order_relaxed)) {
+            _min.store(value, std::memory_order_relaxed);
+        }
+        if (value > _max.load(std::memory_order_relaxed)) {
+            _max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /// Return the percentiles of the values recorded so far. All members are zero if nothing has been recorded.
+    LatencySummary summary() const
+    {
+        uint64_t counts[bucketCount];
+        uint64_t count = 0;
+        for (std::size_t i = 0; i < bucketCount; ++i) {
+            counts[i] = _buckets[i].load(std::memory_order_relaxed);
+            count += counts[i];
+        }
+
+        LatencySummary summary = {count, 0, 0, 0, 0, 0, 0, 0};
+        if (!count) {
+            return summary;
+        }
+        summary.min = _min.load(std::memory_order_relaxed);
+        summary.max = _max.load(std::memory_order_relaxed);
+        summary.mean = _sum.load(std::memory_order_relaxed) / count;
+
+        const double quantiles[4] = {0.5, 0.9, 0.99, 0.999};
+        uint64_t* results[4] = {&summary.p50, &summary.p90, &summary.p99, &summary.p999};
+        uint64_t seen = 0;
+        std::size_t q = 0;
+        for (std::size_t i = 0; i < bucketCount && q < 4; ++i) {
+            seen += counts[i];
+            while (q < 4 && seen >= quantiles[q] * count) {
+                uint64_t limit = bucketLimit(i);
+                *results[q++] = limit < summary.max ? limit : summary.max;
+            }
+        }
+        return summary;
+    }
+
+    /// Forget all values. Must not be called concurrently with record().
+    void reset()
+    {
+        for (std::size_t i = 0; i < bucketCount; ++i) {
+            _buckets[i].store(0, std::memory_order_relaxed);
+        }
+        _sum.store(0, std::memory_order_relaxed);
+        _min.store(static_cast<uint64_t>(-1), std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+    }
+
+    /// Return the bucket that counts \a value.
+    static std::size_t bucketOf(uint64_t value)
+    {
+        if (value < 8) {
+            return static_cast<std::size_t>(value);
+        }
+        unsigned int exponent = floorLog2(value);
+        std::size_t bucket = (exponent - 2) * 8 + static_cast<std::size_t>((value >> (exponent - 3)) & 7);
+        return bucket < bucketCount ? bucket : bucketCount - 1;
+    }
+
+    /// Return the largest value counted by \a bucket.
+    static uint64_t bucketLimit(std::size_t bucket)
+    {
+        if (bucket < 8) {
+            return bucket;
+        }
+        unsigned int shift = static_cast<unsigned int>(bucket / 8 - 1);
+        return ((8 + static_cast<uint64_t>(bucket % 8) + 1) << shift) - 1;
+    }
+
+private:
+    static unsigned int floorLog2(uint64_t value)
+    {
+        unsigned int result = 0;
+        for (unsigned int shift = 32; shift; shift /= 2) {
+            if (value >> shift) {
+                value >>= shift;
+                result += shift;
+            }
+        }
+        return result;
+    }
+
+    std::atomic<uint64_t> _buckets[bucketCount];
+    std::atomic<uint64_t> _sum;
+    std::atomic<uint64_t> _min;
+    std::atomic<uint64_t> _max;
+
+    // Not implemented
+    LatencyHistogram(const LatencyHistogram&); // = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&); // = delete;
+};
+
+/// A DispatchObserver that measures a hub's hot path: how many events of each type arrive, how old they are when the
+/// hub receives them and once all listeners have handled them, and how long each listener takes per event.
+///
+/// Install it with Hub::setDispatchObserver() and read the figures at any time, from any thread, with snapshot().
+/// Each listener call costs two steady clock reads and a few relaxed atomic stores, and each event two more reads;
+/// with three listeners, that is about 400 ns per event on a typical Linux machine.
+///
+/// libmyo does not specify the epoch of event timestamps, so ages are measured against the steady clock shifted to
+/// give the youngest event seen so far an age of zero. They therefore show how much longer than the quickest event
+/// each event waited in libmyo and the hub, which is what matters for finding latency, but not the absolute time
+/// since the packet arrived.
+///
+/// Timing per listener and end-to-end latency are recorded on the thread that calls the listeners, and event ages on
+/// the thread that runs the event loop, so the profiler works with events diverted to a queue by
+/// Hub::setEventSink(). Up to maxListeners listeners are timed; further ones only count towards the latency.
+class HubProfiler : public DispatchObserver {
+public:
+    /// Number of event types told apart; types beyond libmyo's are counted with the last one.
+    enum { eventTypes = 16 };
+
+    /// Number of listeners that are timed individually.
+    enum { maxListeners = 32 };
+
+    /// Figures for one type of event.
+    struct EventProfile {
+        uint64_t received;        ///< Number of events received from libmyo, including events nobody listens to.
+        LatencySummary age;       ///< Age of the events when the hub received them.
+        LatencySummary latency;   ///< Age of the events once every listener had returned.
+    };
+
+    /// Figures for one listener.
+    struct ListenerProfile {
+        DeviceListener* listener;
+        LatencySummary dispatch;  ///< Time spent in the listener per event or batch of samples.
+    };
+
+    /// The figures at one point in time.
+    struct Snapshot {
+        EventProfile events[eventTypes];        ///< Indexed by libmyo_event_type_t.
+        std::vector<ListenerProfile> listeners; ///< In the order in which the listeners were first called.
+
+        /// Return the listener with the highest 99th percentile dispatch time, or null if none has been called.
+        const ListenerProfile* slowestListener() const
+        {
+            const ListenerProfile* slowest = 0;
+            for (std::size_t i = 0; i < listeners.size(); ++i) {
+                if (!slowest || listeners[i].dispatch.p99 > slowest->dispatch.p99) {
+                    slowest = &listeners[i];
+                }
+            }
+            return slowest;
+        }
+    };
+
+    HubProfiler()
+    : _histograms(new LatencyHistogram[2 * eventTypes + maxListeners])
+    , _begin(0)
+    , _lastListener(0)
+    , _lastHistogram(0)
+    {
+        for (std::size_t i = 0; i < eventTypes; ++i) {
+            _received[i].store(0, std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < maxListeners; ++i) {
+            _listeners[i].store(0, std::memory_order_relaxed);
+        }
+        _skew.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+    }
+
+    /// Return the figures recorded so far.
+    Snapshot snapshot() const
+    {
+        Snapshot snapshot;
+        for (std::size_t i = 0; i < eventTypes; ++i) {
+            snapshot.events[i].received = _received[i].load(std::memory_order_relaxed);
+            snapshot.events[i].age = ageHistogram(i).summary();
+            snapshot.events[i].latency = latencyHistogram(i).summary();
+        }
+        for (std::size_t i = 0; i < maxListeners; ++i) {
+            DeviceListener* listener = _listeners[i].load(std::memory_order_acquire);
+            if (!listener) {
+                break;
+            }
+            ListenerProfile profile = {listener, _histograms[2 * eventTypes + i].summary()};
+            snapshot.listeners.push_back(profile);
+        }
+        return snapshot;
+    }
+
+    /// Forget all figures. Must not be called while the hub is running or dispatching events.
+    void reset()
+    {
+        for (std::size_t i = 0; i < 2 * eventTypes + maxListeners; ++i) {
+            _histograms[i].reset();
+        }
+        for (std::size_t i = 0; i < eventTypes; ++i) {
+            _received[i].store(0, std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < maxListeners; ++i) {
+            _listeners[i].store(0, std::memory_order_relaxed);
+        }
+        _skew.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+        _lastListener = 0;
+        _lastHistogram = 0;
+    }
+
+    void onEventReceived(uint32_t type, uint64_t timestamp)
+    {
+        std::size_t index = typeIndex(type);
+        _received[index].store(_received[index].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        ageHistogram(index).record(age(timestamp, now()));
+    }
+
+    void onListenerBegin(DeviceListener* listener, uint32_t type)
+    {
+        _begin = now();
+    }
+
+    void onListenerEnd(DeviceListener* listener, uint32_t type)
+    {
+        uint64_t end = now();
+        if (LatencyHistogram* histogram = listenerHistogram(listener)) {
+            histogram->record(end - _begin);
+        }
+    }
+
+    void onEventHandled(uint32_t type, uint64_t timestamp)
+    {
+        latencyHistogram(typeIndex(type)).record(age(timestamp, now()));
+    }
+
+private:
+    static uint64_t now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static std::size_t typeIndex(uint32_t type)
+    {
+        return type < eventTypes ? type : eventTypes - 1;
+    }
+
+    LatencyHistogram& ageHistogram(std::size_t index) const { return _histograms[index]; }
+    LatencyHistogram& latencyHistogram(std::size_t index) const { return _histograms[eventTypes + index]; }
+
+    // Return the age at \a time, in nanoseconds, of an event with the libmyo \a timestamp, in microseconds.
+    uint64_t age(uint64_t timestamp, uint64_t time)
+    {
+        int64_t skew = static_cast<int64_t>(time) - static_cast<int64_t>(timestamp * 1000);
+        int64_t youngest = _skew.load(std::memory_order_relaxed);
+        while (skew < youngest && !_skew.compare_exchange_weak(youngest, skew, std::memory_order_relaxed)) {
+        }
+        return skew > youngest ? static_cast<uint64_t>(skew - youngest) : 0;
+    }
+
+    LatencyHistogram* listenerHistogram(DeviceListener* listener)
+    {
+        // Consecutive calls usually go to the same few listeners in the same order.
+        if (listener == _lastListener) {
+            return _lastHistogram;
+        }
+        for (std::size_t i = 0; i < maxListeners; ++i) {
+            DeviceListener* known = _listeners[i].load(std::memory_order_relaxed);
+            if (!known) {
+                _listeners[i].store(listener, std::memory_order_release);
+            } else if (known != listener) {
+                continue;
+            }
+            _lastListener = listener;
+            _lastHistogram = &_histograms[2 * eventTypes + i];
+            return _lastHistogram;
+        }
+        return 0;
+    }
+
+    // Ages, latencies and listener times, in that order.
+    std::unique_ptr<LatencyHistogram[]> _histograms;
+    std::atomic<uint64_t> _received[eventTypes];
+    std::atomic<DeviceListener*> _listeners[maxListeners];
+    std::atomic<int64_t> _skew;     // Smallest difference seen between the clock and a timestamp, in nanoseconds.
+
+    // Only used on the thread calling the listeners.
+    uint64_t _begin;
+    DeviceListener* _lastListener;
+    LatencyHistogram* _lastHistogram;
+
+    // Not implemented
+    HubProfiler(const HubProfiler&); // = delete;
+    HubProfiler& operator=(const HubProfiler&); // = delete;
+};
+
+} // namespace myo
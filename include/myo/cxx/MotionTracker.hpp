@@ -0,0 +1,93 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+// MotionTracker uses the SIMD batch functions of QuaternionArray and is therefore not included by myo.hpp; include
+// this header explicitly.
+
+#include <stdint.h>
+
+#include "DeviceListener.hpp"
+#include "QuaternionArray.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+#include "detail/MyoTracks.hpp"
+
+namespace myo {
+
+class Myo;
+
+/// The motion of a Myo at one IMU sample, fused from its orientation, accelerometer and gyroscope readings.
+/// The world frame is the frame of the orientation quaternion, whose z axis points up.
+struct MotionSample {
+    uint64_t timestamp;                ///< Timestamp of the IMU sample.
+    Vector3<float> gravity;            ///< Direction of gravity in the Myo's own frame, in units of g.
+    Vector3<float> linearAcceleration; ///< Acceleration with gravity removed, in the world frame, in m/s^2.
+    Vector3<float> velocity;           ///< Velocity integrated from linearAcceleration, in the world frame, in m/s.
+    bool stationary;                   ///< True while the Myo is held still.
+};
+
+/// A DeviceListener that combines the orientation, accelerometer and gyroscope readings of each IMU sample into
+/// gravity-compensated linear acceleration, a velocity estimate and a stationary detector.
+///
+/// The Myo is stationary once its acceleration has stayed within \a stillAcceleration of 1 g and its angular speed
+/// below \a stillRotation for \a stillTime. Integrated velocity drifts, so it is reset to zero while the Myo is
+/// stationary and decays towards zero with time constant \a velocityTimeConstant otherwise.
+///
+/// Subscribed to Hub::eventImuBatch in place of Hub::eventOrientation on a hub that batches IMU samples (see
+/// Hub::setBatchSize()), the tracker works on whole batches and rotates them into the world frame with the SIMD batch
+/// functions; otherwise it handles one sample at a time. It must not be subscribed to both, or each sample is counted
+/// twice. Once the state of a Myo has been created on its first sample, neither path allocates memory.
+class MotionTracker : public DeviceListener {
+public:
+    /// Create a tracker with the given thresholds.
+    /// \a stillAcceleration is in units of g, \a stillRotation in deg/s, \a stillTime in microseconds and
+    /// \a velocityTimeConstant in seconds.
+    explicit MotionTracker(float stillAcceleration = 0.05f, float stillRotation = 10.0f, uint64_t stillTime = 200000,
+                           float velocityTimeConstant = 2.0f);
+
+    /// Forget the motion of every Myo.
+    void reset();
+
+    /// Return the most recent motion of \a myo. All members are zero if no IMU sample has been received.
+    MotionSample motion(Myo* myo) const;
+
+    /// Return true if \a myo is currently stationary.
+    bool isStationary(Myo* myo) const;
+
+    /// Called for every IMU sample of \a myo once it has been fused.
+    virtual void onMotion(Myo* myo, const MotionSample& motion) {}
+
+    void onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation);
+    void onAccelerometerData(Myo* myo, uint64_t timestamp, const Vector3<float>& accel);
+    void onGyroscopeData(Myo* myo, uint64_t timestamp, const Vector3<float>& gyro);
+    void onImuBatch(Myo* myo, const ImuBatch& batch);
+    void onDisconnect(Myo* myo, uint64_t timestamp);
+    void onUnpair(Myo* myo, uint64_t timestamp);
+
+private:
+    struct Track {
+        bool started;
+        Quaternion<float> rotation;
+        Vector3<float> accel;
+        uint64_t stillSince;
+        MotionSample motion;
+    };
+
+    void update(Myo* myo, Track& track, uint64_t timestamp, const Quaternion<float>& rotation,
+                const Vector3<float>& worldAccel, float accelMagnitude, float rotationSpeed);
+
+    float _stillAcceleration;
+    float _stillRotation;
+    uint64_t _stillTime;
+    float _velocityTimeConstant;
+    MyoTracks<Track> _tracks;
+
+    // Scratch columns for onImuBatch(), grown to the largest batch seen.
+    QuaternionArray _batchRotation;
+    Vector3Array _batchAccel;
+};
+
+} // namespace myo
+
+#include "impl/MotionTracker_impl.hpp"
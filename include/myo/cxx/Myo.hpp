@@ -2,14 +2,27 @@
 // Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
 #pragma once
 
+#include <cstddef>
+
 #include <myo/libmyo.h>
 
+#include "DeviceState.hpp"
+#include "ErrorCode.hpp"
+#include "detail/CommandQueue.hpp"
+
 namespace myo {
 
+template<typename Track>
+class MyoTracks;
+
 /// Represents a Myo device with a specific MAC address.
 /// This class can not be instantiated directly; instead, use Hub to get access to a Myo.
 /// There is only one Myo instance corresponding to each device; thus, if the addresses of two Myo instances compare
 /// equal, they refer to the same device.
+/// Each function that calls into libmyo comes in two forms: one that throws std::invalid_argument or
+/// std::runtime_error on failure, and one that takes an ErrorCode and never throws.
+/// If the Hub queues commands (see Hub::setCommandRate()), the functions that send a command to the Myo return as soon
+/// as it is queued, and both forms report success; failures to send it are reported by the Hub's event loop.
 class Myo {
 public:
     /// Types of vibration supported by the Myo.
@@ -21,14 +34,17 @@ public:
 
     /// Vibrate the Myo.
     void vibrate(VibrationType type);
+    void vibrate(VibrationType type, ErrorCode& error);
 
     /// Request the RSSI of the Myo. An onRssi event will likely be generated with the value of the RSSI.
     /// @see DeviceListener::onRssi()
     void requestRssi() const;
+    void requestRssi(ErrorCode& error) const;
 
     /// Request the battery level of the Myo. An onBatteryLevelReceived event will be generated with the value.
     /// @see DeviceListener::onBatteryLevelReceived().
     void requestBatteryLevel() const;
+    void requestBatteryLevel(ErrorCode& error) const;
 
     /// Unlock types supported by Myo.
     enum UnlockType {
@@ -39,15 +55,20 @@ public:
     /// Unlock the Myo.
     /// Myo will remain unlocked for a short amount of time, after which it will automatically lock again.
     /// If Myo was locked, an onUnlock event will be generated.
+    /// A hold unlock is sent again when the Myo reconnects, until lock() or a timed unlock is requested.
+    /// @see Hub::setRestoreOnConnect()
     void unlock(UnlockType type);
+    void unlock(UnlockType type, ErrorCode& error);
 
     /// Force the Myo to lock immediately.
     /// If Myo was unlocked, an onLock event will be generated.
     void lock();
+    void lock(ErrorCode& error);
 
     /// Notify the Myo that a user action was recognized.
     /// Will cause Myo to vibrate.
     void notifyUserAction();
+    void notifyUserAction(ErrorCode& error);
 
     /// Valid EMG streaming modes for a Myo.
     enum StreamEmgType {
@@ -56,7 +77,9 @@ public:
     };
 
     /// Sets the EMG streaming mode for a Myo.
+    /// The mode is sent again when the Myo reconnects. @see Hub::setRestoreOnConnect()
     void setStreamEmg(StreamEmgType type);
+    void setStreamEmg(StreamEmgType type, ErrorCode& error);
 
     /// @cond MYO_INTERNALS
 
@@ -69,13 +92,26 @@ private:
     Myo(libmyo_myo_t myo);
     ~Myo();
 
+    // Queue a command if the Hub asked for commands to be queued. Return false if it must be sent right away.
+    bool queue(CommandQueue::Kind kind, int value) const;
+
     libmyo_myo_t _myo;
 
+    // Position of this Myo in the owning Hub's list of Myos.
+    std::size_t _index;
+
+    // Commands waiting to be sent by the owning Hub.
+    mutable CommandQueue _commands;
+
+    // Maintained by the owning Hub, except for the requested configuration.
+    DeviceState _state;
+
     // Not implemented.
     Myo(const Myo&);
     Myo& operator=(const Myo&);
 
     friend class Hub;
+    template<typename Track> friend class MyoTracks;
 };
 
 } // namespace myo
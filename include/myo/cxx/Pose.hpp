@@ -41,6 +41,13 @@ public:
     /// Return a human-readable string representation of the pose.
     std::string toString() const;
 
+    /// Return the name of the pose, as returned by toString(), without allocating.
+    /// The returned string is static and must not be freed.
+    const char* name() const;
+
+    /// Return the name of poses of type \a type, or "<invalid>" if \a type is not a type of pose.
+    static const char* name(Type type);
+
 private:
     Type _type;
 };
@@ -0,0 +1,117 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include "EmgFeatures.hpp"
+#include "detail/MyoTracks.hpp"
+
+namespace myo {
+
+class Myo;
+
+/// A trainable classifier that recognizes application-defined poses from the EMG stream, in addition to the poses
+/// libmyo reports through DeviceListener::onPose().
+///
+/// Poses are identified by integers chosen by the application. Starting them at libmyo_num_poses keeps them apart
+/// from the values of Pose::Type, so that both kinds can be handled by the same code.
+///
+/// The classifier is a linear discriminant analysis over the 32 values of EmgFeatures: each feature is standardized,
+/// and each pose gets a linear score whose weights solve the pooled within-pose covariance, shrunk towards the
+/// identity by \a shrinkage, against the pose's mean. Examples are accumulated into running sums, so recording costs
+/// no memory per example. For inference the standardized features and the weights are quantized to 8 bits, and the
+/// scores are integer dot products, so classifying a window takes well under a microsecond for a handful of poses.
+class PoseClassifier : public EmgFeatureExtractor {
+public:
+    /// Reported when no pose is recognized with enough confidence.
+    enum { unknownPose = -1 };
+
+    /// Number of values taken from each EmgFeatures: RMS, MAV, zero crossings and waveform length of 8 sensors.
+    enum { featureCount = 32 };
+
+    /// Largest number of poses a classifier can be trained on.
+    enum { maxPoses = 64 };
+
+    /// Create an untrained classifier over EMG windows of \a window samples, classifying every \a hop samples.
+    /// A pose is only reported if its estimated probability is at least \a minConfidence.
+    /// Throws an exception of type std::invalid_argument for the same reasons as EmgFeatureExtractor.
+    explicit PoseClassifier(std::size_t window = 40, std::size_t hop = 10, float shrinkage = 0.1f,
+                            float minConfidence = 0.6f);
+
+    /// Add \a features as an example of \a pose.
+    void addExample(int pose, const EmgFeatures& features);
+
+    /// Add the features of every following EMG window, from any Myo, as examples of \a pose until stopRecording().
+    void record(int pose);
+
+    /// Stop adding windows as examples.
+    void stopRecording();
+
+    /// Return true between record() and stopRecording().
+    bool isRecording() const { return _recording; }
+
+    /// Return the number of examples of \a pose.
+    std::size_t exampleCount(int pose) const;
+
+    /// Discard all examples. The trained model, if any, is kept.
+    void clearExamples();
+
+    /// Fit the model to the examples added so far, replacing any previous model.
+    /// Throws an exception of type std::logic_error if fewer than two or more than maxPoses poses have examples.
+    void train();
+
+    /// Return true once train() has succeeded.
+    bool isTrained() const { return !_poses.empty(); }
+
+    /// Return the pose that best matches \a features, or unknownPose if none is confident enough or the classifier
+    /// is not trained. If \a confidence is not null, the probability of the returned pose is stored there.
+    int classify(const EmgFeatures& features, float* confidence = 0) const;
+
+    /// Return the pose most recently recognized for \a myo, or unknownPose.
+    int pose(Myo* myo) const;
+
+    /// Called when the pose recognized for \a myo changes, including changes to unknownPose.
+    virtual void onExtendedPose(Myo* myo, uint64_t timestamp, int pose, float confidence) {}
+
+    void onEmgFeatures(Myo* myo, const EmgFeatures& features);
+    void onDisconnect(Myo* myo, uint64_t timestamp);
+    void onUnpair(Myo* myo, uint64_t timestamp);
+
+private:
+    struct Examples {
+        std::size_t count;
+        double sum[featureCount];
+    };
+
+    static void featureVector(const EmgFeatures& features, float* out);
+    static bool factor(std::vector<double>& matrix);
+    static void solve(const std::vector<double>& factor, double* vector);
+
+    float _shrinkage;
+    float _minConfidence;
+    bool _recording;
+    int _recordingPose;
+
+    // Training sums: per-pose sums of the features and the scatter matrix of all examples.
+    std::map<int, Examples> _examples;
+    std::vector<double> _scatter;
+
+    // The trained model.
+    std::vector<int> _poses;
+    float _mean[featureCount];
+    float _inverseStdDev[featureCount];
+    std::vector<int8_t> _weights;   // featureCount weights per pose.
+    std::vector<float> _scales;     // Converts a pose's integer dot product into its score.
+    std::vector<float> _biases;
+
+    MyoTracks<int> _current;
+};
+
+} // namespace myo
+
+#include "impl/PoseClassifier_impl.hpp"
@@ -0,0 +1,71 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <stdint.h>
+
+#include "DeviceListener.hpp"
+#include "Pose.hpp"
+#include "detail/MyoTracks.hpp"
+
+namespace myo {
+
+class Myo;
+
+/// A DeviceListener that turns the pose events of each Myo into transitions: a pose is entered, held and exited.
+///
+/// onPoseEnter() and onPoseExit() are called for every change of pose, with the time spent in the exited pose.
+/// While a pose other than rest or unknown is held, onPoseHold() is called each time another \a holdInterval has
+/// passed, so that an application can tell a held pose from a brief one without polling a clock. Time is taken from
+/// the event timestamps: holds are detected on the orientation events, which arrive at 50 Hz, so a hold is reported
+/// at most 20 ms late. A hold interval of zero disables onPoseHold().
+///
+/// When a Myo disconnects or is unpaired, its current pose is exited.
+class PoseTracker : public DeviceListener {
+public:
+    /// Create a tracker that reports held poses every \a holdInterval microseconds.
+    explicit PoseTracker(uint64_t holdInterval = 500000);
+
+    /// Return the interval between two onPoseHold() calls, in microseconds.
+    uint64_t holdInterval() const { return _holdInterval; }
+
+    /// Forget the pose of every Myo without reporting any transitions.
+    void reset();
+
+    /// Return the current pose of \a myo, or Pose::unknown if it has not reported one.
+    Pose pose(Myo* myo) const;
+
+    /// Return how long \a myo has been in its current pose as of its latest event, in microseconds.
+    uint64_t poseDuration(Myo* myo) const;
+
+    /// Called when \a myo enters \a pose.
+    virtual void onPoseEnter(Myo* myo, uint64_t timestamp, Pose pose) {}
+
+    /// Called every holdInterval() while \a myo holds \a pose, \a duration after entering it.
+    virtual void onPoseHold(Myo* myo, uint64_t timestamp, Pose pose, uint64_t duration) {}
+
+    /// Called when \a myo leaves \a pose after \a duration microseconds.
+    virtual void onPoseExit(Myo* myo, uint64_t timestamp, Pose pose, uint64_t duration) {}
+
+    void onPose(Myo* myo, uint64_t timestamp, Pose pose);
+    void onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation);
+    void onDisconnect(Myo* myo, uint64_t timestamp);
+    void onUnpair(Myo* myo, uint64_t timestamp);
+
+private:
+    struct Track {
+        Pose pose;
+        uint64_t since;     // Timestamp at which pose was entered.
+        uint64_t latest;    // Timestamp of the latest event.
+        uint64_t holds;     // Number of onPoseHold() calls for pose so far.
+    };
+
+    void exit(Myo* myo, uint64_t timestamp);
+
+    uint64_t _holdInterval;
+    MyoTracks<Track> _tracks;
+};
+
+} // namespace myo
+
+#include "impl/PoseTracker_impl.hpp"
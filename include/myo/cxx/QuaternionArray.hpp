@@ -0,0 +1,202 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+#include "detail/SimdPack.hpp"
+
+namespace myo {
+
+/// An array of quaternions stored as one contiguous column per component.
+/// This is the layout expected by the batch functions below, which process many quaternions per instruction.
+class QuaternionArray {
+  public:
+    /// Construct an empty array.
+    QuaternionArray() {}
+
+    /// Construct an array of \a size quaternions that represent zero rotation.
+    explicit QuaternionArray(std::size_t size) { resize(size); }
+
+    /// Return the number of quaternions in the array.
+    std::size_t size() const { return _x.size(); }
+
+    /// Change the number of quaternions in the array. New elements represent zero rotation.
+    void resize(std::size_t size)
+    {
+        _x.resize(size, 0);
+        _y.resize(size, 0);
+        _z.resize(size, 0);
+        _w.resize(size, 1);
+    }
+
+    /// Reserve storage for \a capacity quaternions.
+    void reserve(std::size_t capacity)
+    {
+        _x.reserve(capacity);
+        _y.reserve(capacity);
+        _z.reserve(capacity);
+        _w.reserve(capacity);
+    }
+
+    /// Remove all quaternions from the array.
+    void clear() { resize(0); }
+
+    /// Append \a quat to the array.
+    void push_back(const Quaternion<float>& quat)
+    {
+        _x.push_back(quat.x());
+        _y.push_back(quat.y());
+        _z.push_back(quat.z());
+        _w.push_back(quat.w());
+    }
+
+    /// Return the quaternion at index \a i.
+    Quaternion<float> operator[](std::size_t i) const { return Quaternion<float>(_x[i], _y[i], _z[i], _w[i]); }
+
+    /// Replace the quaternion at index \a i with \a quat.
+    void set(std::size_t i, const Quaternion<float>& quat)
+    {
+        _x[i] = quat.x();
+        _y[i] = quat.y();
+        _z[i] = quat.z();
+        _w[i] = quat.w();
+    }
+
+    /// Return the x-components of the quaternions' vectors.
+    float* x() { return data(_x); }
+    const float* x() const { return data(_x); }
+
+    /// Return the y-components of the quaternions' vectors.
+    float* y() { return data(_y); }
+    const float* y() const { return data(_y); }
+
+    /// Return the z-components of the quaternions' vectors.
+    float* z() { return data(_z); }
+    const float* z() const { return data(_z); }
+
+    /// Return the w-components (scalars) of the quaternions.
+    float* w() { return data(_w); }
+    const float* w() const { return data(_w); }
+
+  private:
+    static float* data(std::vector<float>& column) { return column.empty() ? 0 : &column[0]; }
+    static const float* data(const std::vector<float>& column) { return column.empty() ? 0 : &column[0]; }
+
+    std::vector<float> _x, _y, _z, _w;
+};
+
+/// An array of vectors stored as one contiguous column per component.
+class Vector3Array {
+  public:
+    /// Construct an empty array.
+    Vector3Array() {}
+
+    /// Construct an array of \a size zero vectors.
+    explicit Vector3Array(std::size_t size) { resize(size); }
+
+    /// Return the number of vectors in the array.
+    std::size_t size() const { return _x.size(); }
+
+    /// Change the number of vectors in the array. New elements are zero vectors.
+    void resize(std::size_t size)
+    {
+        _x.resize(size, 0);
+        _y.resize(size, 0);
+        _z.resize(size, 0);
+    }
+
+    /// Reserve storage for \a capacity vectors.
+    void reserve(std::size_t capacity)
+    {
+        _x.reserve(capacity);
+        _y.reserve(capacity);
+        _z.reserve(capacity);
+    }
+
+    /// Remove all vectors from the array.
+    void clear() { resize(0); }
+
+    /// Append \a vec to the array.
+    void push_back(const Vector3<float>& vec)
+    {
+        _x.push_back(vec.x());
+        _y.push_back(vec.y());
+        _z.push_back(vec.z());
+    }
+
+    /// Return the vector at index \a i.
+    Vector3<float> operator[](std::size_t i) const { return Vector3<float>(_x[i], _y[i], _z[i]); }
+
+    /// Replace the vector at index \a i with \a vec.
+    void set(std::size_t i, const Vector3<float>& vec)
+    {
+        _x[i] = vec.x();
+        _y[i] = vec.y();
+        _z[i] = vec.z();
+    }
+
+    /// Return the x-components of the vectors.
+    float* x() { return data(_x); }
+    const float* x() const { return data(_x); }
+
+    /// Return the y-components of the vectors.
+    float* y() { return data(_y); }
+    const float* y() const { return data(_y); }
+
+    /// Return the z-components of the vectors.
+    float* z() { return data(_z); }
+    const float* z() const { return data(_z); }
+
+  private:
+    static float* data(std::vector<float>& column) { return column.empty() ? 0 : &column[0]; }
+    static const float* data(const std::vector<float>& column) { return column.empty() ? 0 : &column[0]; }
+
+    std::vector<float> _x, _y, _z;
+};
+
+/// Return the instruction set level used by the batch functions.
+/// This defaults to the widest level supported by the processor.
+simd::Level simdLevel();
+
+/// Use instruction set level \a level for the batch functions, for example to compare results against the scalar
+/// path. Levels wider than the processor supports are lowered to the widest supported level.
+/// This affects all threads and should not be called while batch functions are running.
+void setSimdLevel(simd::Level level);
+
+// The batch functions below resize \a out to the size of their inputs. \a out may be one of the inputs.
+// They throw an exception of type std::invalid_argument if two inputs differ in size.
+
+/// Store \a lhs[i] * \a rhs[i] in \a out[i] for every i.
+/// \relates myo::QuaternionArray
+void multiply(const QuaternionArray& lhs, const QuaternionArray& rhs, QuaternionArray& out);
+
+/// Store the unit quaternion corresponding to the same rotation as \a quats[i] in \a out[i] for every i.
+/// \relates myo::QuaternionArray
+void normalize(const QuaternionArray& quats, QuaternionArray& out);
+
+/// Store the conjugate of \a quats[i] in \a out[i] for every i.
+/// \relates myo::QuaternionArray
+void conjugate(const QuaternionArray& quats, QuaternionArray& out);
+
+/// Store \a vecs[i] rotated by \a quats[i] in \a out[i] for every i. The quaternions must be unit quaternions.
+/// \relates myo::QuaternionArray
+void rotate(const QuaternionArray& quats, const Vector3Array& vecs, Vector3Array& out);
+
+/// Store the spherical linear interpolation between unit quaternions \a from[i] and \a to[i] at \a t, which should
+/// be between 0 and 1, in \a out[i] for every i. The shorter of the two arcs is taken.
+/// The interpolation weights are evaluated with a polynomial rather than trigonometric functions; the result is
+/// accurate to within a few units in the last place of a float.
+/// \relates myo::QuaternionArray
+void slerp(const QuaternionArray& from, const QuaternionArray& to, float t, QuaternionArray& out);
+
+/// Store a normalized copy of \a vecs[i] in \a out[i] for every i.
+/// \relates myo::Vector3Array
+void normalize(const Vector3Array& vecs, Vector3Array& out);
+
+} // namespace myo
+
+#include "impl/QuaternionArray_impl.hpp"
@@ -0,0 +1,201 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "DeviceListener.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+#include "detail/MappedFile.hpp"
+#include "detail/MyoTracks.hpp"
+#include "detail/SampleBatcher.hpp"
+
+namespace myo {
+
+class Myo;
+
+/// Kinds of chunk stored in a session file.
+enum SessionChunkKind {
+    sessionChunkEmg = 1, ///< EMG samples: 8 int8_t columns.
+    sessionChunkImu = 2  ///< IMU samples: 10 float columns (orientation x, y, z, w; accelerometer; gyroscope).
+};
+
+/// Summary of one chunk of a session file.
+/// The index at the end of the file holds one of these per chunk, so that a scan can select chunks by device, time
+/// range or value range without touching the sample data.
+struct SessionChunkInfo {
+    uint32_t kind;           ///< A SessionChunkKind.
+    uint32_t device;         ///< Index of the device into SessionReader::devices().
+    uint32_t size;           ///< Number of samples in the chunk.
+    uint32_t reserved;
+    uint64_t firstTimestamp; ///< Timestamp of the first sample.
+    uint64_t lastTimestamp;  ///< Timestamp of the last sample.
+    uint64_t offset;         ///< Position of the chunk's columns within the file.
+    float minimum[10];       ///< Smallest value of each column. EMG chunks use the first 8 entries.
+    float maximum[10];       ///< Largest value of each column. EMG chunks use the first 8 entries.
+};
+
+/// A zero-copy view of the EMG samples in one chunk of a session file.
+class EmgSpan {
+public:
+    /// Return the number of samples.
+    std::size_t size() const { return _size; }
+
+    /// Return the timestamp of sample \a i.
+    uint64_t timestamp(std::size_t i) const { return _firstTimestamp + _deltas[i]; }
+
+    /// Return the timestamp of each sample relative to the first, in microseconds.
+    const uint32_t* timestampDeltas() const { return _deltas; }
+
+    /// Return the readings of \a sensor, which must be smaller than 8, for every sample.
+    const int8_t* channel(unsigned int sensor) const { return _channels[sensor]; }
+
+private:
+    std::size_t _size;
+    uint64_t _firstTimestamp;
+    const uint32_t* _deltas;
+    const int8_t* _channels[8];
+
+    friend class SessionReader;
+};
+
+/// A zero-copy view of the IMU samples in one chunk of a session file.
+class ImuSpan {
+public:
+    /// Return the number of samples.
+    std::size_t size() const { return _size; }
+
+    /// Return the timestamp of sample \a i.
+    uint64_t timestamp(std::size_t i) const { return _firstTimestamp + _deltas[i]; }
+
+    /// Return the timestamp of each sample relative to the first, in microseconds.
+    const uint32_t* timestampDeltas() const { return _deltas; }
+
+    /// Return column \a index for every sample: orientation x, y, z, w (0-3), accelerometer x, y, z (4-6) or
+    /// gyroscope x, y, z (7-9).
+    const float* column(unsigned int index) const { return _columns[index]; }
+
+    /// Return the orientation of sample \a i.
+    Quaternion<float> orientation(std::size_t i) const
+    {
+        return Quaternion<float>(_columns[0][i], _columns[1][i], _columns[2][i], _columns[3][i]);
+    }
+
+    /// Return the accelerometer reading of sample \a i, in units of g.
+    Vector3<float> accelerometer(std::size_t i) const
+    {
+        return Vector3<float>(_columns[4][i], _columns[5][i], _columns[6][i]);
+    }
+
+    /// Return the gyroscope reading of sample \a i, in units of deg/s.
+    Vector3<float> gyroscope(std::size_t i) const
+    {
+        return Vector3<float>(_columns[7][i], _columns[8][i], _columns[9][i]);
+    }
+
+private:
+    std::size_t _size;
+    uint64_t _firstTimestamp;
+    const uint32_t* _deltas;
+    const float* _columns[10];
+
+    friend class SessionReader;
+};
+
+/// A DeviceListener that stores EMG and IMU samples in a chunked, columnar session file.
+///
+/// Samples are grouped per device into chunks of up to \a chunkSize samples. Within a chunk, timestamps are stored
+/// as 32 bit offsets from the first sample, followed by one column per EMG channel or IMU component, each padded to
+/// 8 bytes. An index of SessionChunkInfo entries, the MAC address of each device and a trailer locating both are
+/// written when the writer is closed. Values are stored in the byte order of the writing machine.
+/// @see SessionReader
+class SessionWriter : public DeviceListener {
+public:
+    /// Create or truncate the session file at \a path.
+    /// Throws an exception of type std::runtime_error if the file cannot be opened.
+    explicit SessionWriter(const std::string& path, std::size_t chunkSize = 1024);
+
+    /// Close the file if close() has not been called.
+    ~SessionWriter();
+
+    /// Write out pending samples, the index and the trailer, and close the file. Later samples are ignored.
+    void close();
+
+    void onPair(Myo* myo, uint64_t timestamp, FirmwareVersion firmwareVersion);
+    void onUnpair(Myo* myo, uint64_t timestamp);
+    void onDisconnect(Myo* myo, uint64_t timestamp);
+    void onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation);
+    void onAccelerometerData(Myo* myo, uint64_t timestamp, const Vector3<float>& accel);
+    void onGyroscopeData(Myo* myo, uint64_t timestamp, const Vector3<float>& gyro);
+    void onEmgData(Myo* myo, uint64_t timestamp, const int8_t* emg);
+
+private:
+    struct Device {
+        uint32_t index;
+        SampleBatcher samples;
+        uint64_t firstEmgTimestamp;
+        uint64_t firstImuTimestamp;
+    };
+
+    Device& device(Myo* myo);
+    void flushEmg(Device& device);
+    void flushImu(Device& device);
+    void writeChunk(SessionChunkInfo& info, const uint32_t* deltas, const void* const* columns,
+                    std::size_t columnCount, std::size_t valueSize);
+    void writeBytes(const void* data, std::size_t size);
+    void pad();
+
+    std::FILE* _file;
+    uint64_t _offset;
+    std::size_t _chunkSize;
+    MyoTracks<Device> _devices;
+    std::vector<uint64_t> _macAddresses;
+    std::vector<SessionChunkInfo> _index;
+    std::vector<uint32_t> _deltas;
+    DeviceEvent::Imu _imu;
+
+    // Not implemented
+    SessionWriter(const SessionWriter&); // = delete;
+    SessionWriter& operator=(const SessionWriter&); // = delete;
+};
+
+/// Reads a session file written by SessionWriter by mapping it into memory.
+/// Chunks are exposed as views directly into the mapping; nothing is parsed or copied until a column is read.
+class SessionReader {
+public:
+    /// Map the session file at \a path.
+    /// Throws an exception of type std::runtime_error if the file cannot be mapped, is not a complete session file,
+    /// or was written on a machine with a different byte order.
+    explicit SessionReader(const std::string& path);
+
+    /// Return the MAC addresses of the recorded devices, indexed by SessionChunkInfo::device.
+    const std::vector<uint64_t>& devices() const { return _devices; }
+
+    /// Return the number of chunks in the file.
+    std::size_t chunkCount() const { return _chunkCount; }
+
+    /// Return the index entry of chunk \a i.
+    const SessionChunkInfo& chunk(std::size_t i) const { return _index[i]; }
+
+    /// Return the samples of chunk \a i.
+    /// Throws an exception of type std::invalid_argument if the chunk does not hold EMG samples.
+    EmgSpan emg(std::size_t i) const;
+
+    /// Return the samples of chunk \a i.
+    /// Throws an exception of type std::invalid_argument if the chunk does not hold IMU samples.
+    ImuSpan imu(std::size_t i) const;
+
+private:
+    MappedFile _file;
+    const SessionChunkInfo* _index;
+    std::size_t _chunkCount;
+    std::vector<uint64_t> _devices;
+};
+
+} // namespace myo
+
+#include "impl/SessionFile_impl.hpp"
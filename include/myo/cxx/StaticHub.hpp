@@ -0,0 +1,267 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+// StaticHub requires C++11 variadic templates and is therefore not included by myo.hpp; include this header
+// explicitly.
+
+#include <stdint.h>
+
+#include <string>
+#include <tuple>
+
+#include <myo/libmyo.h>
+
+#include "DeviceListener.hpp"
+#include "ErrorCode.hpp"
+#include "Hub.hpp"
+#include "Myo.hpp"
+#include "Pose.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+#include "detail/StaticDispatch.hpp"
+#include "detail/ThrowOnError.hpp"
+
+namespace myo {
+
+/// A hub that calls a fixed set of listeners chosen at compile time.
+///
+/// A Hub calls its listeners through the virtual functions of DeviceListener, so nothing past the virtual call can be
+/// inlined into its event loop. A StaticHub instead takes the listener types as template arguments and calls their
+/// member functions directly. The listener types do not need to derive from DeviceListener: each one only defines the
+/// callbacks it is interested in, with the same names and parameters as in DeviceListener, and the hub detects which
+/// ones exist. Event types no listener handles are discarded without reading their payload, the remaining payloads
+/// are read straight into the callback arguments, and the whole path from libmyo to the listeners can be inlined.
+///
+/// Listeners are called in the order they are given, and each one receives the orientation, accelerometer and
+/// gyroscope callbacks of an IMU sample before the next listener receives any, as with Hub. Unlike Hub, every listener
+/// gets onOpaqueEvent() before any listener gets the typed callback for the same event.
+///
+/// A listener type that derives from DeviceListener is called for every event, through its virtual functions.
+/// Listeners are held by reference and must outlive the hub. StaticHub does not support event sinks or batching.
+///
+/// \code
+/// struct PoseCounter {
+///     void onPose(myo::Myo* myo, uint64_t timestamp, myo::Pose pose) { ++count; }
+///     int count;
+/// };
+///
+/// PoseCounter counter = {0};
+/// myo::StaticHub<PoseCounter> hub("com.example.pose-counter", counter);
+/// hub.run(1000);
+/// \endcode
+template<typename... Listeners>
+class StaticHub : private Hub {
+public:
+    /// Construct a hub that calls \a listeners. Throws the same exceptions as the Hub constructor.
+    StaticHub(const std::string& applicationIdentifier, Listeners&... listeners)
+    : Hub(applicationIdentifier)
+    , _listeners(listeners...)
+    {
+    }
+
+    /// Construct a hub that calls \a listeners, reporting failures through \a error instead of throwing.
+    StaticHub(const std::string& applicationIdentifier, ErrorCode& error, Listeners&... listeners)
+    : Hub(applicationIdentifier, error)
+    , _listeners(listeners...)
+    {
+    }
+
+    using Hub::waitForMyo;
+    using Hub::setShard;
+
+    using Hub::LockingPolicy;
+    using Hub::lockingPolicyNone;
+    using Hub::lockingPolicyStandard;
+    using Hub::setLockingPolicy;
+
+    using Hub::libmyoObject;
+
+    /// Run the event loop for the specified duration (in milliseconds).
+    void run(unsigned int duration_ms)
+    {
+        ErrorCode error;
+        run(duration_ms, error);
+        throwIfFailed(error);
+    }
+
+    void run(unsigned int duration_ms, ErrorCode& error)
+    {
+        libmyo_run(_hub, duration_ms, &handler<libmyo_handler_continue>, this, error);
+    }
+
+    /// Run the event loop until a single event occurs, or the specified duration (in milliseconds) has elapsed.
+    void runOnce(unsigned int duration_ms)
+    {
+        ErrorCode error;
+        runOnce(duration_ms, error);
+        throwIfFailed(error);
+    }
+
+    void runOnce(unsigned int duration_ms, ErrorCode& error)
+    {
+        libmyo_run(_hub, duration_ms, &handler<libmyo_handler_stop>, this, error);
+    }
+
+private:
+    template<typename Tag>
+    struct Handled : callback::HandledByAny<Tag, Listeners...> {};
+
+    template<libmyo_handler_result_t Result>
+    static libmyo_handler_result_t handler(void* userData, libmyo_event_t event)
+    {
+        static_cast<StaticHub*>(userData)->onEvent(event);
+        return Result;
+    }
+
+    template<typename Tag, typename... Args>
+    void invoke(const Args&... args)
+    {
+        callback::ForEach<0, sizeof...(Listeners)>::template invoke<Tag>(_listeners, args...);
+    }
+
+    void onEvent(libmyo_event_t event)
+    {
+        libmyo_myo_t opaqueMyo = libmyo_event_get_myo(event);
+        uint32_t type = libmyo_event_get_type(event);
+
+        Myo* myo = lookupMyo(opaqueMyo);
+
+        if (!myo && type == libmyo_event_paired && ownsMyo(opaqueMyo)) {
+            myo = addMyo(opaqueMyo);
+        }
+
+        if (!myo) {
+            // Ignore events for Myos we don't know about.
+            return;
+        }
+
+        if (Handled<callback::OnOpaqueEvent>::value) {
+            invoke<callback::OnOpaqueEvent>(event);
+        }
+
+        // Each case reads only the payload its listeners take; the conditions are constants, so cases nobody
+        // handles compile down to nothing.
+        switch (type) {
+        case libmyo_event_paired:
+            if (Handled<callback::OnPair>::value) {
+                invoke<callback::OnPair>(myo, libmyo_event_get_timestamp(event), firmwareVersion(event));
+            }
+            break;
+        case libmyo_event_unpaired:
+            if (Handled<callback::OnUnpair>::value) {
+                invoke<callback::OnUnpair>(myo, libmyo_event_get_timestamp(event));
+            }
+            break;
+        case libmyo_event_connected:
+            if (Handled<callback::OnConnect>::value) {
+                invoke<callback::OnConnect>(myo, libmyo_event_get_timestamp(event), firmwareVersion(event));
+            }
+            break;
+        case libmyo_event_disconnected:
+            if (Handled<callback::OnDisconnect>::value) {
+                invoke<callback::OnDisconnect>(myo, libmyo_event_get_timestamp(event));
+            }
+            break;
+        case libmyo_event_arm_synced:
+            if (Handled<callback::OnArmSync>::value) {
+                invoke<callback::OnArmSync>(myo, libmyo_event_get_timestamp(event),
+                                            static_cast<Arm>(libmyo_event_get_arm(event)),
+                                            static_cast<XDirection>(libmyo_event_get_x_direction(event)),
+                                            libmyo_event_get_rotation_on_arm(event),
+                                            static_cast<WarmupState>(libmyo_event_get_warmup_state(event)));
+            }
+            break;
+        case libmyo_event_arm_unsynced:
+            if (Handled<callback::OnArmUnsync>::value) {
+                invoke<callback::OnArmUnsync>(myo, libmyo_event_get_timestamp(event));
+            }
+            break;
+        case libmyo_event_unlocked:
+            if (Handled<callback::OnUnlock>::value) {
+                invoke<callback::OnUnlock>(myo, libmyo_event_get_timestamp(event));
+            }
+            break;
+        case libmyo_event_locked:
+            if (Handled<callback::OnLock>::value) {
+                invoke<callback::OnLock>(myo, libmyo_event_get_timestamp(event));
+            }
+            break;
+        case libmyo_event_orientation:
+            if (Handled<callback::OnOrientationData>::value || Handled<callback::OnAccelerometerData>::value
+                || Handled<callback::OnGyroscopeData>::value) {
+                // Like Hub, each listener gets all three parts of the sample before the next listener gets any.
+                // Parts nobody takes are not read.
+                Quaternion<float> rotation;
+                Vector3<float> accel, gyro;
+                if (Handled<callback::OnOrientationData>::value) {
+                    rotation = Quaternion<float>(libmyo_event_get_orientation(event, libmyo_orientation_x),
+                                                 libmyo_event_get_orientation(event, libmyo_orientation_y),
+                                                 libmyo_event_get_orientation(event, libmyo_orientation_z),
+                                                 libmyo_event_get_orientation(event, libmyo_orientation_w));
+                }
+                if (Handled<callback::OnAccelerometerData>::value) {
+                    accel = Vector3<float>(libmyo_event_get_accelerometer(event, 0),
+                                           libmyo_event_get_accelerometer(event, 1),
+                                           libmyo_event_get_accelerometer(event, 2));
+                }
+                if (Handled<callback::OnGyroscopeData>::value) {
+                    gyro = Vector3<float>(libmyo_event_get_gyroscope(event, 0), libmyo_event_get_gyroscope(event, 1),
+                                          libmyo_event_get_gyroscope(event, 2));
+                }
+                callback::ForEach<0, sizeof...(Listeners)>::invokeImu(_listeners, myo,
+                                                                      libmyo_event_get_timestamp(event), rotation,
+                                                                      accel, gyro);
+            }
+            break;
+        case libmyo_event_pose:
+            if (Handled<callback::OnPose>::value) {
+                invoke<callback::OnPose>(myo, libmyo_event_get_timestamp(event),
+                                         Pose(static_cast<Pose::Type>(libmyo_event_get_pose(event))));
+            }
+            break;
+        case libmyo_event_rssi:
+            if (Handled<callback::OnRssi>::value) {
+                invoke<callback::OnRssi>(myo, libmyo_event_get_timestamp(event), libmyo_event_get_rssi(event));
+            }
+            break;
+        case libmyo_event_battery_level:
+            if (Handled<callback::OnBatteryLevelReceived>::value) {
+                invoke<callback::OnBatteryLevelReceived>(myo, libmyo_event_get_timestamp(event),
+                                                         libmyo_event_get_battery_level(event));
+            }
+            break;
+        case libmyo_event_emg:
+            if (Handled<callback::OnEmgData>::value) {
+                int8_t emg[8];
+                for (unsigned int i = 0; i < 8; ++i) {
+                    emg[i] = libmyo_event_get_emg(event, i);
+                }
+                invoke<callback::OnEmgData>(myo, libmyo_event_get_timestamp(event), static_cast<const int8_t*>(emg));
+            }
+            break;
+        case libmyo_event_warmup_completed:
+            if (Handled<callback::OnWarmupCompleted>::value) {
+                invoke<callback::OnWarmupCompleted>(myo, libmyo_event_get_timestamp(event),
+                    static_cast<WarmupResult>(libmyo_event_get_warmup_result(event)));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    static FirmwareVersion firmwareVersion(libmyo_event_t event)
+    {
+        FirmwareVersion version;
+        version.firmwareVersionMajor = libmyo_event_get_firmware_version(event, libmyo_version_major);
+        version.firmwareVersionMinor = libmyo_event_get_firmware_version(event, libmyo_version_minor);
+        version.firmwareVersionPatch = libmyo_event_get_firmware_version(event, libmyo_version_patch);
+        version.firmwareVersionHardwareRev = libmyo_event_get_firmware_version(event, libmyo_version_hardware_rev);
+        return version;
+    }
+
+    std::tuple<Listeners&...> _listeners;
+};
+
+} // namespace myo
@@ -0,0 +1,162 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "DeviceListener.hpp"
+#include "Quaternion.hpp"
+#include "Vector3.hpp"
+#include "detail/MyoTracks.hpp"
+
+namespace myo {
+
+class Myo;
+
+/// The EMG and IMU readings of one Myo, resampled to the time of a SyncedFrame.
+struct SyncedSample {
+    Myo* myo;
+    bool hasEmg;                   ///< False if the Myo has no EMG samples around the time of the frame.
+    bool hasImu;                   ///< False if the Myo has no IMU samples around the time of the frame.
+    float emg[8];                  ///< EMG reading of each sensor, interpolated between samples.
+    Quaternion<float> orientation; ///< Orientation, interpolated between samples.
+    Vector3<float> accel;          ///< Acceleration in units of g, interpolated between samples.
+    Vector3<float> gyro;           ///< Angular velocity in deg/s, interpolated between samples.
+};
+
+/// The readings of every Myo at one point of a common timeline.
+struct SyncedFrame {
+    uint64_t timestamp;            ///< Time of the frame, a multiple of the frame period.
+    std::size_t size;              ///< Number of Myos in the frame.
+    const SyncedSample* samples;   ///< One sample per Myo, in the order in which the Myos first sent data.
+};
+
+/// The clock of one sample stream of a Myo, as estimated by StreamSynchronizer.
+struct StreamClock {
+    double period;                 ///< Estimated sample period, in microseconds.
+    double drift;                  ///< Deviation of the period from the nominal one, in parts per million.
+    double offset;                 ///< Correction applied to the timestamp of the latest sample, in microseconds.
+    double jitter;                 ///< Mean absolute deviation of timestamps from the clock, in microseconds.
+};
+
+/// A DeviceListener that aligns the EMG and IMU streams of several Myos onto a common timeline.
+///
+/// Event timestamps are taken when the SDK receives a packet, so they carry the jitter of the Bluetooth link on top
+/// of the sample clock of each armband, which runs at its own rate and phase. For each stream of each Myo the
+/// synchronizer tracks the sample clock, so every sample gets the time at which it was taken on a clock that
+/// advances by the estimated period, corrected for lost samples. The rate of the clock, which both streams of an
+/// armband share, is fitted to the timestamps of the last thousand or so IMU samples. The streams are then
+/// resampled by interpolation at every multiple of \a framePeriod, and onSyncedFrame() is called with the readings
+/// of all Myos at that time. With the default period of 5 ms, the EMG sample period, the samples of all arms in a
+/// frame are aligned to within a fraction of a sample period.
+///
+/// A frame is delivered once every active stream has passed its time. A stream that falls more than \a maxLatency
+/// behind the newest one is left out of the frames it has not caught up with, so that one armband dropping out does
+/// not stall the others. Once the history of a Myo has been created on its first sample, no memory is allocated.
+class StreamSynchronizer : public DeviceListener {
+public:
+    /// Create a synchronizer that emits frames every \a framePeriod microseconds, at most \a maxLatency
+    /// microseconds behind the newest sample.
+    /// Throws an exception of type std::invalid_argument if \a framePeriod is 0.
+    explicit StreamSynchronizer(uint64_t framePeriod = 5000, uint64_t maxLatency = 40000);
+
+    /// Return the time between frames, in microseconds.
+    uint64_t framePeriod() const { return _framePeriod; }
+
+    /// Forget the samples and clocks of every Myo.
+    void reset();
+
+    /// Return the estimated clock of the EMG stream of \a myo. All members are zero if it has not sent EMG data.
+    StreamClock emgClock(Myo* myo) const;
+
+    /// Return the estimated clock of the IMU stream of \a myo. All members are zero if it has not sent IMU data.
+    StreamClock imuClock(Myo* myo) const;
+
+    /// Called with the readings of every Myo at each point of the common timeline.
+    virtual void onSyncedFrame(const SyncedFrame& frame) {}
+
+    void onEmgData(Myo* myo, uint64_t timestamp, const int8_t* emg);
+    void onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation);
+    void onAccelerometerData(Myo* myo, uint64_t timestamp, const Vector3<float>& accel);
+    void onGyroscopeData(Myo* myo, uint64_t timestamp, const Vector3<float>& gyro);
+    void onDisconnect(Myo* myo, uint64_t timestamp);
+    void onUnpair(Myo* myo, uint64_t timestamp);
+
+private:
+    // Tracks the sample clock of a stream. Each sample is expected a period after the previous one, and the clock
+    // moves part of the way towards its timestamp. The rate of the clock is fitted by least squares to the
+    // timestamps of the recent samples against their sample numbers, older samples weighing exponentially less.
+    struct SampleClock {
+        double nominal;
+        double time;      // Clock time of the latest sample.
+        double offset;
+        double jitter;
+        bool started;
+        double reference; // Timestamp of the latest sample, the origin of the sums below.
+        double weight;
+        double sumX;
+        double sumY;
+        double sumXX;
+        double sumXY;
+
+        double update(uint64_t timestamp, double rate);
+        bool fitted() const;
+        double rate() const;
+        StreamClock estimate(double rate) const;
+    };
+
+    struct EmgSlot {
+        double time;
+        int8_t emg[8];
+    };
+
+    struct ImuSlot {
+        double time;
+        float orientation[4];
+        float accel[3];
+        float gyro[3];
+    };
+
+    // The most recent samples of a stream, oldest first from the slot after the newest.
+    template<typename Slot>
+    struct History {
+        SampleClock clock;
+        std::vector<Slot> slots;
+        std::size_t newest;
+        std::size_t count;
+
+        void push(const Slot& slot);
+        double latest() const { return count ? slots[newest].time : 0; }
+        bool find(double time, const Slot*& before, const Slot*& after, float& fraction) const;
+    };
+
+    struct Track {
+        Myo* myo;
+        History<EmgSlot> emg;
+        History<ImuSlot> imu;
+        ImuSlot pending;          // IMU sample being assembled from its three callbacks.
+
+        // Return the rate of the armband's clock relative to nominal.
+        double rate() const;
+    };
+
+    Track& track(Myo* myo);
+    void updateOrder();
+    void emitFrames();
+    void resample(const Track& track, double time, SyncedSample& sample) const;
+
+    uint64_t _framePeriod;
+    uint64_t _maxLatency;
+    uint64_t _next;               // Time of the next frame, or 0 before the first sample.
+    MyoTracks<Track> _tracks;
+    std::vector<Myo*> _order;     // Myos in the order in which they first sent data.
+    std::vector<Track*> _ordered; // Their tracks, looked up again whenever a track is started or dropped.
+    std::vector<SyncedSample> _frame;
+};
+
+} // namespace myo
+
+#include "impl/StreamSynchronizer_impl.hpp"
@@ -0,0 +1,81 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#pragma once
+
+#include <stdint.h>
+
+#include "DeviceListener.hpp"
+#include "Quaternion.hpp"
+#include "detail/MyoTracks.hpp"
+
+namespace myo {
+
+class Myo;
+
+/// A DeviceListener that turns the tilt of each Myo into scroll steps, for moving through a list by tilting the arm.
+///
+/// Tilt is the pitch or roll of the Myo relative to a neutral angle, zero unless set with setNeutral(). Within
+/// \a deadZone radians of neutral nothing happens. Beyond it, the Myo scrolls at a rate that grows from \a minRate to
+/// \a maxRate steps per second as the tilt approaches \a fullTilt, following a power curve of exponent \a exponent.
+/// Tilt above the neutral angle scrolls forward, in positive steps, and tilt below it scrolls back.
+///
+/// Scrolling is timed from the timestamps of the orientation events, so it never blocks the event loop: the first
+/// step is taken as soon as the tilt leaves the dead zone, and further steps as the elapsed time accumulates. Gaps of
+/// more than 100 ms between events, e.g. after a reconnect, do not count towards the next step.
+class TiltScroller : public DeviceListener {
+public:
+    /// The angle that is scrolled along.
+    enum Axis {
+        pitchAxis, ///< Tilting the arm up or down.
+        rollAxis   ///< Rotating the forearm.
+    };
+
+    /// Create a scroller with the given velocity curve. Angles are in radians and rates in steps per second.
+    /// Throws an exception of type std::invalid_argument if \a fullTilt is not larger than \a deadZone or
+    /// \a maxRate is smaller than \a minRate.
+    explicit TiltScroller(float deadZone = 0.35f, float fullTilt = 1.4f, float minRate = 3.0f, float maxRate = 9.0f,
+                          float exponent = 1.5f, Axis axis = pitchAxis);
+
+    /// Forget the tilt and neutral angle of every Myo.
+    void reset();
+
+    /// Take the current tilt of \a myo as its neutral angle.
+    void setNeutral(Myo* myo);
+
+    /// Return the current tilt of \a myo relative to its neutral angle, in radians within [-pi, pi].
+    float tilt(Myo* myo) const;
+
+    /// Return the rate at which \a myo is currently scrolling, in steps per second; negative when scrolling back.
+    float rate(Myo* myo) const;
+
+    /// Called when \a myo scrolls by \a steps, which is negative when scrolling back.
+    virtual void onScroll(Myo* myo, uint64_t timestamp, int steps) {}
+
+    void onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation);
+    void onDisconnect(Myo* myo, uint64_t timestamp);
+    void onUnpair(Myo* myo, uint64_t timestamp);
+
+private:
+    struct Track {
+        uint64_t timestamp;  // Timestamp of the latest orientation, or 0 before the first one.
+        float angle;         // Latest absolute angle.
+        float neutral;
+        int direction;       // Sign of the current scroll, or 0 within the dead zone.
+        float progress;      // Fraction of a step accumulated towards the next one.
+    };
+
+    static float wrapAngle(float angle);
+    float rateFor(float tilt) const;
+
+    float _deadZone;
+    float _fullTilt;
+    float _minRate;
+    float _maxRate;
+    float _exponent;
+    Axis _axis;
+    MyoTracks<Track> _tracks;
+};
+
+} // namespace myo
+
+#include "impl/TiltScroller_impl.hpp"
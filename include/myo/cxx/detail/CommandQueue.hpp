@@ -0,0 +1,197 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_CXX_DETAIL_COMMANDQUEUE_HPP
+#define MYO_CXX_DETAIL_COMMANDQUEUE_HPP
+
+#include <stdint.h>
+
+#include <cstddef>
+
+#include <myo/libmyo.h>
+
+#include "../ErrorCode.hpp"
+
+namespace myo {
+
+/// Holds the commands waiting to be sent to one Myo.
+///
+/// Each kind of command has a single slot, so a command that is issued again before the previous one was sent
+/// collapses into it: vibrations keep the longest of the stacked types, while locks and unlocks, and changes to the
+/// EMG stream, keep the latest. A hold unlock, or an EMG stream mode, that is already in effect is dropped. Commands
+/// leave in the order they were first issued, at a rate limited by a token bucket.
+class CommandQueue {
+public:
+    enum Kind {
+        commandVibrate,
+        commandLock,                // Value: lockValue, or a libmyo_unlock_type_t.
+        commandNotifyUserAction,
+        commandStreamEmg,
+        commandRequestRssi,
+        commandRequestBatteryLevel,
+        commandKinds
+    };
+
+    enum { lockValue = -1, unknownValue = -2 };
+
+    CommandQueue()
+    : _enabled(false)
+    , _pending(0)
+    , _sequence(0)
+    , _credit(0)
+    , _refilled(0)
+    , _lockSent(unknownValue)
+    , _streamSent(unknownValue)
+    {
+        for (std::size_t i = 0; i < commandKinds; ++i) {
+            _slots[i].pending = false;
+            _slots[i].value = 0;
+            _slots[i].sequence = 0;
+        }
+    }
+
+    /// Return true if commands are queued rather than sent as they are issued.
+    bool enabled() const { return _enabled; }
+
+    void setEnabled(bool enabled) { _enabled = enabled; }
+
+    /// Return true if no command is waiting.
+    bool empty() const { return _pending == 0; }
+
+    /// Queue a command of \a kind, merging it with a waiting command of the same kind.
+    void push(Kind kind, int value)
+    {
+        Slot& slot = _slots[kind];
+
+        if ((kind == commandLock && value == libmyo_unlock_hold && _lockSent == libmyo_unlock_hold)
+            || (kind == commandStreamEmg && value == _streamSent)) {
+            // Already in effect; whatever was waiting has been superseded.
+            if (slot.pending) {
+                slot.pending = false;
+                --_pending;
+            }
+            return;
+        }
+
+        if (kind == commandVibrate && slot.pending) {
+            slot.value = value > slot.value ? value : slot.value;
+        } else {
+            slot.value = value;
+        }
+
+        if (!slot.pending) {
+            slot.pending = true;
+            slot.sequence = ++_sequence;
+            ++_pending;
+        }
+    }
+
+    /// Take the oldest waiting command if the rate limit allows sending one at time \a now, in microseconds.
+    /// The queue earns one command every \a interval microseconds, up to \a burst commands; an interval of zero
+    /// lifts the limit.
+    bool next(uint64_t now, uint64_t interval, std::size_t burst, Kind& kind, int& value)
+    {
+        if (!_pending) {
+            return false;
+        }
+
+        if (interval) {
+            if (now > _refilled) {
+                _credit += now - _refilled;
+                _refilled = now;
+            }
+            const uint64_t capacity = interval * burst;
+            if (_credit > capacity) {
+                _credit = capacity;
+            }
+            if (_credit < interval) {
+                return false;
+            }
+            _credit -= interval;
+        }
+
+        std::size_t oldest = commandKinds;
+        for (std::size_t i = 0; i < commandKinds; ++i) {
+            if (_slots[i].pending && (oldest == commandKinds || _slots[i].sequence < _slots[oldest].sequence)) {
+                oldest = i;
+            }
+        }
+
+        Slot& slot = _slots[oldest];
+        slot.pending = false;
+        --_pending;
+        kind = static_cast<Kind>(oldest);
+        value = slot.value;
+
+        if (kind == commandLock) {
+            _lockSent = value;
+        } else if (kind == commandStreamEmg) {
+            _streamSent = value;
+        }
+        return true;
+    }
+
+    /// Forget that a hold unlock is in effect, because the Myo has locked.
+    void forgetLock() { _lockSent = unknownValue; }
+
+    /// Discard the waiting commands and what is known to be in effect, e.g. because the Myo has disconnected.
+    void clear()
+    {
+        for (std::size_t i = 0; i < commandKinds; ++i) {
+            _slots[i].pending = false;
+        }
+        _pending = 0;
+        _lockSent = unknownValue;
+        _streamSent = unknownValue;
+    }
+
+    /// Send a command of \a kind to \a myo through libmyo.
+    static void send(libmyo_myo_t myo, Kind kind, int value, ErrorCode& error)
+    {
+        switch (kind) {
+        case commandVibrate:
+            libmyo_vibrate(myo, static_cast<libmyo_vibration_type_t>(value), error);
+            break;
+        case commandLock:
+            if (value == lockValue) {
+                libmyo_myo_lock(myo, error);
+            } else {
+                libmyo_myo_unlock(myo, static_cast<libmyo_unlock_type_t>(value), error);
+            }
+            break;
+        case commandNotifyUserAction:
+            libmyo_myo_notify_user_action(myo, static_cast<libmyo_user_action_type_t>(value), error);
+            break;
+        case commandStreamEmg:
+            libmyo_set_stream_emg(myo, static_cast<libmyo_stream_emg_t>(value), error);
+            break;
+        case commandRequestRssi:
+            libmyo_request_rssi(myo, error);
+            break;
+        case commandRequestBatteryLevel:
+            libmyo_request_battery_level(myo, error);
+            break;
+        case commandKinds:
+            break;
+        }
+    }
+
+private:
+    struct Slot {
+        bool pending;
+        int value;
+        unsigned long sequence; // Order in which the waiting commands were first issued.
+    };
+
+    bool _enabled;
+    std::size_t _pending;
+    unsigned long _sequence;
+    uint64_t _credit;     // Microseconds of sending time earned.
+    uint64_t _refilled;   // Time up to which credit has been earned.
+    int _lockSent;
+    int _streamSent;
+    Slot _slots[commandKinds];
+};
+
+} // namespace myo
+
+#endif // MYO_CXX_DETAIL_COMMANDQUEUE_HPP
@@ -0,0 +1,193 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_CXX_DETAIL_HEALTHPOLLER_HPP
+#define MYO_CXX_DETAIL_HEALTHPOLLER_HPP
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <myo/libmyo.h>
+
+#include "../DeviceEvent.hpp"
+#include "../DeviceHealth.hpp"
+#include "../ErrorCode.hpp"
+#include "../Myo.hpp"
+
+namespace myo {
+
+/// Keeps the DeviceHealth record of each Myo of a hub and schedules the RSSI and battery level requests that keep
+/// them current. Myos are identified by their position in the hub's list of Myos.
+class HealthPoller {
+public:
+    HealthPoller()
+    : _rssiInterval(0)
+    , _batteryInterval(0)
+    , _jitter(0)
+    , _random(0x9e3779b9u)
+    , _tracks()
+    {
+    }
+
+    /// Request the RSSI every \a rssiInterval and the battery level every \a batteryInterval microseconds, varying
+    /// each interval at random by up to \a jitter times its length. Zero intervals stop the requests.
+    void setIntervals(uint64_t rssiInterval, uint64_t batteryInterval, float jitter)
+    {
+        // A jitter near 1 would let an interval shrink to nothing and send the next request on the following poll,
+        // so no interval is allowed to shrink below half its length.
+        const float maxJitter = 0.5f;
+
+        _rssiInterval = rssiInterval;
+        _batteryInterval = batteryInterval;
+        _jitter = jitter < 0 ? 0 : (jitter > maxJitter ? maxJitter : jitter);
+        for (std::size_t i = 0; i < _tracks.size(); ++i) {
+            _tracks[i].nextRssi = 0;
+            _tracks[i].nextBattery = 0;
+        }
+    }
+
+    bool polling() const { return _rssiInterval || _batteryInterval; }
+
+    /// Start a record for the Myo at \a index.
+    void addMyo(std::size_t index, uint64_t macAddress)
+    {
+        if (index >= _tracks.size()) {
+            Track track = {};
+            _tracks.resize(index + 1, track);
+        }
+        _tracks[index].health.macAddress = macAddress;
+        _tracks[index].changed = true;
+    }
+
+    const DeviceHealth& health(std::size_t index) const { return _tracks[index].health; }
+
+    /// Update the record of the Myo at \a index with \a event, whose payload must have been decoded for RSSI and
+    /// battery level events.
+    void onEvent(std::size_t index, const DeviceEvent& event)
+    {
+        Track& track = _tracks[index];
+        DeviceHealth& health = track.health;
+        health.lastSeen = event.timestamp;
+        track.changed = true;
+
+        switch (event.type) {
+        case libmyo_event_connected:
+            if (!health.connected) {
+                health.connected = true;
+                // Schedule the first requests on the next poll.
+                track.nextRssi = 0;
+                track.nextBattery = 0;
+                track.rssiOutstanding = false;
+                track.batteryOutstanding = false;
+            }
+            break;
+        case libmyo_event_disconnected:
+        case libmyo_event_unpaired:
+            health.connected = false;
+            break;
+        case libmyo_event_rssi:
+            health.rssi = event.rssi;
+            if (health.rssiTimestamp) {
+                health.smoothedRssi += 0.25f * (health.rssi - health.smoothedRssi);
+            } else {
+                health.smoothedRssi = health.rssi;
+            }
+            health.rssiTimestamp = event.timestamp;
+            track.rssiOutstanding = false;
+            break;
+        case libmyo_event_battery_level:
+            health.batteryLevel = event.batteryLevel;
+            health.batteryTimestamp = event.timestamp;
+            track.batteryOutstanding = false;
+            break;
+        default:
+            break;
+        }
+    }
+
+    /// Issue the requests due at \a now to the connected Myos among \a myos.
+    void poll(const std::vector<Myo*>& myos, uint64_t now, ErrorCode& error)
+    {
+        for (std::size_t i = 0, ie = _tracks.size() < myos.size() ? _tracks.size() : myos.size(); i < ie; ++i) {
+            Track& track = _tracks[i];
+            if (!track.health.connected) {
+                continue;
+            }
+
+            if (_rssiInterval && due(i, now, _rssiInterval, track.nextRssi, track.rssiOutstanding, track)) {
+                myos[i]->requestRssi(error);
+                if (error.failed()) {
+                    return;
+                }
+            }
+            if (_batteryInterval && due(i, now, _batteryInterval, track.nextBattery, track.batteryOutstanding, track)) {
+                myos[i]->requestBatteryLevel(error);
+                if (error.failed()) {
+                    return;
+                }
+            }
+        }
+    }
+
+    /// Hand the records that changed since the last call to \a sink.
+    void publish(DeviceHealthSink* sink)
+    {
+        for (std::size_t i = 0; i < _tracks.size(); ++i) {
+            if (_tracks[i].changed) {
+                _tracks[i].changed = false;
+                sink->update(i, _tracks[i].health);
+            }
+        }
+    }
+
+private:
+    struct Track {
+        DeviceHealth health;
+        uint64_t nextRssi;     // Time the next request is due; zero until the first one is scheduled.
+        uint64_t nextBattery;
+        bool rssiOutstanding;
+        bool batteryOutstanding;
+        bool changed;          // Not yet handed to the sink.
+    };
+
+    // Return true if a request is due at \a now, and schedule the one after it.
+    bool due(std::size_t index, uint64_t now, uint64_t interval, uint64_t& next, bool& outstanding, Track& track)
+    {
+        if (!next) {
+            // Give each Myo its own phase within the interval. Multiples of the golden ratio stay evenly spread
+            // however many Myos there are, without moving the Myos already placed.
+            double phase = index * 0.6180339887498949;
+            phase -= static_cast<uint64_t>(phase);
+            next = now + static_cast<uint64_t>(phase * interval) + 1;
+            return false;
+        }
+        if (now < next) {
+            return false;
+        }
+
+        if (outstanding) {
+            ++track.health.missedRequests;
+            track.changed = true;
+        }
+        outstanding = true;
+
+        // xorshift32, mapped onto [-1, 1).
+        _random ^= _random << 13;
+        _random ^= _random >> 17;
+        _random ^= _random << 5;
+        const double u = _random / 2147483648.0 - 1;
+        next = now + static_cast<uint64_t>(interval * (1 + _jitter * u));
+        return true;
+    }
+
+    uint64_t _rssiInterval;
+    uint64_t _batteryInterval;
+    float _jitter;
+    uint32_t _random;
+    std::vector<Track> _tracks;
+};
+
+} // namespace myo
+
+#endif // MYO_CXX_DETAIL_HEALTHPOLLER_HPP
@@ -0,0 +1,103 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_CXX_DETAIL_MAPPEDFILE_HPP
+#define MYO_CXX_DETAIL_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+# include "Windows.hpp"
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace myo {
+
+/// A read-only memory mapping of an entire file.
+class MappedFile {
+public:
+    /// Map the file at \a path.
+    /// Throws an exception of type std::runtime_error if the file cannot be opened or mapped.
+    explicit MappedFile(const std::string& path)
+    : _data(0)
+    , _size(0)
+    {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, 0);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Unable to open " + path);
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            throw std::runtime_error("Unable to determine the size of " + path);
+        }
+        _size = static_cast<std::size_t>(size.QuadPart);
+        if (_size) {
+            HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+            if (mapping) {
+                _data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Unable to open " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Unable to determine the size of " + path);
+        }
+        _size = static_cast<std::size_t>(info.st_size);
+        if (_size) {
+            void* data = ::mmap(0, _size, PROT_READ, MAP_SHARED, fd, 0);
+            if (data != MAP_FAILED) {
+                _data = static_cast<const unsigned char*>(data);
+            }
+        }
+        ::close(fd);
+#endif
+        if (_size && !_data) {
+            throw std::runtime_error("Unable to map " + path);
+        }
+    }
+
+    ~MappedFile()
+    {
+        if (!_data) {
+            return;
+        }
+#if defined(_WIN32)
+        UnmapViewOfFile(_data);
+#else
+        ::munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+    }
+
+    /// Return the start of the mapping. The mapping is aligned to a page boundary.
+    const unsigned char* data() const { return _data; }
+
+    /// Return the size of the file in bytes.
+    std::size_t size() const { return _size; }
+
+private:
+    const unsigned char* _data;
+    std::size_t _size;
+
+    // Not implemented
+    MappedFile(const MappedFile&); // = delete;
+    MappedFile& operator=(const MappedFile&); // = delete;
+};
+
+} // namespace myo
+
+#endif // MYO_CXX_DETAIL_MAPPEDFILE_HPP
@@ -0,0 +1,140 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_CXX_DETAIL_MYOTABLE_HPP
+#define MYO_CXX_DETAIL_MYOTABLE_HPP
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include <myo/libmyo.h>
+
+namespace myo {
+
+class Myo;
+
+/// Flat open-addressing map from libmyo_myo_t handles to Myo instances.
+/// Lookups hash the handle and probe linearly, so their cost does not depend on the number of paired Myos. The
+/// table is kept at most half full. Entries are never removed, matching the lifetime of Myo instances in a Hub.
+class MyoTable {
+public:
+    MyoTable()
+    : _slots(16)
+    , _size(0)
+    {
+    }
+
+    /// Return the Myo registered for \a key, or null if there is none.
+    Myo* find(libmyo_myo_t key) const
+    {
+        const std::size_t mask = _slots.size() - 1;
+        for (std::size_t i = hash(key) & mask; ; i = (i + 1) & mask) {
+            const Slot& slot = _slots[i];
+            if (slot.key == key) {
+                return slot.value;
+            }
+            if (!slot.key) {
+                return 0;
+            }
+        }
+    }
+
+    /// Register \a value for \a key, which must be non-null and not already present.
+    void insert(libmyo_myo_t key, Myo* value)
+    {
+        if ((_size + 1) * 2 > _slots.size()) {
+            rehash(_slots.size() * 2);
+        }
+        place(key, value);
+        ++_size;
+    }
+
+    /// Return the number of entries in the table.
+    std::size_t size() const { return _size; }
+
+private:
+    struct Slot {
+        Slot() : key(0), value(0) {}
+
+        libmyo_myo_t key;
+        Myo* value;
+    };
+
+    static std::size_t hash(libmyo_myo_t key)
+    {
+        // Handles are heap pointers whose low bits are mostly alignment; mix before masking.
+        std::size_t h = reinterpret_cast<std::size_t>(key);
+        h ^= h >> 4;
+        h *= 0x9e3779b1u;
+        return h ^ (h >> 16);
+    }
+
+    void place(libmyo_myo_t key, Myo* value)
+    {
+        const std::size_t mask = _slots.size() - 1;
+        std::size_t i = hash(key) & mask;
+        while (_slots[i].key) {
+            i = (i + 1) & mask;
+        }
+        _slots[i].key = key;
+        _slots[i].value = value;
+    }
+
+    void rehash(std::size_t capacity)
+    {
+        std::vector<Slot> old(capacity);
+        old.swap(_slots);
+        for (std::vector<Slot>::const_iterator I = old.begin(), IE = old.end(); I != IE; ++I) {
+            if (I->key) {
+                place(I->key, I->value);
+            }
+        }
+    }
+
+    std::vector<Slot> _slots;
+    std::size_t _size;
+};
+
+/// Storage for objects of type \a T, handed out from fixed-size chunks so that addresses remain stable.
+/// The pool only manages raw memory; callers construct and destroy objects in the storage it returns.
+template<typename T>
+class ObjectPool {
+public:
+    ObjectPool()
+    : _chunks()
+    , _used(chunkSize)
+    {
+    }
+
+    ~ObjectPool()
+    {
+        for (std::vector<void*>::iterator I = _chunks.begin(), IE = _chunks.end(); I != IE; ++I) {
+            ::operator delete(*I);
+        }
+    }
+
+    /// Return uninitialized storage suitable for one \a T.
+    void* allocate()
+    {
+        if (_used == chunkSize) {
+            _chunks.reserve(_chunks.size() + 1);
+            _chunks.push_back(::operator new(sizeof(T) * chunkSize));
+            _used = 0;
+        }
+        return static_cast<char*>(_chunks.back()) + sizeof(T) * _used++;
+    }
+
+private:
+    enum { chunkSize = 16 };
+
+    std::vector<void*> _chunks;
+    std::size_t _used;
+
+    // Not implemented
+    ObjectPool(const ObjectPool&); // = delete;
+    ObjectPool& operator=(const ObjectPool&); // = delete;
+};
+
+} // namespace myo
+
+#endif // MYO_CXX_DETAIL_MYOTABLE_HPP
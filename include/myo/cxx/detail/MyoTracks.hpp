@@ -0,0 +1,95 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_CXX_DETAIL_MYOTRACKS_HPP
+#define MYO_CXX_DETAIL_MYOTRACKS_HPP
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "../Myo.hpp"
+
+namespace myo {
+
+/// Longest gap, in microseconds, between consecutive samples of a Myo that listeners treat as one continuous stream.
+/// A longer gap, e.g. after a reconnect, restarts whatever they estimate from the stream.
+const uint64_t maxStreamGap = 100000;
+
+/// The per-Myo state of a listener, indexed by the position of each Myo in its Hub, so that finding the state of the
+/// Myo an event came from takes no search. A null Myo, as in events read back from a log, has a track of its own.
+/// The tracks of one MyoTracks must all belong to Myos of the same Hub. Starting a track may move the others, so
+/// references to tracks must not be held across a call to get().
+template<typename Track>
+class MyoTracks {
+public:
+    MyoTracks()
+    : _slots()
+    {
+    }
+
+    /// Return the track of \a myo, starting a value-initialized one if it has none.
+    Track& get(const Myo* myo)
+    {
+        std::size_t index = slotOf(myo);
+        if (index >= _slots.size()) {
+            Slot empty = Slot();
+            _slots.resize(index + 1, empty);
+        }
+        Slot& slot = _slots[index];
+        if (!slot.used) {
+            slot.track = Track();
+            slot.used = true;
+        }
+        return slot.track;
+    }
+
+    /// Return the track of \a myo, or 0 if it has none.
+    Track* find(const Myo* myo)
+    {
+        std::size_t index = slotOf(myo);
+        return index < _slots.size() && _slots[index].used ? &_slots[index].track : 0;
+    }
+
+    const Track* find(const Myo* myo) const
+    {
+        std::size_t index = slotOf(myo);
+        return index < _slots.size() && _slots[index].used ? &_slots[index].track : 0;
+    }
+
+    /// Forget the track of \a myo. Return false if it had none.
+    bool erase(const Myo* myo)
+    {
+        Track* track = find(myo);
+        if (!track) {
+            return false;
+        }
+        // Release what the track holds rather than keeping it until the slot is reused.
+        *track = Track();
+        _slots[slotOf(myo)].used = false;
+        return true;
+    }
+
+    /// Forget every track.
+    void clear() { _slots.clear(); }
+
+    /// Return the number of slots, for visiting every track with at().
+    std::size_t slots() const { return _slots.size(); }
+
+    /// Return the track in slot \a index, or 0 if the slot is unused. Slots are in the order the Myos were paired.
+    Track* at(std::size_t index) { return _slots[index].used ? &_slots[index].track : 0; }
+
+private:
+    struct Slot {
+        bool used;
+        Track track;
+    };
+
+    static std::size_t slotOf(const Myo* myo) { return myo ? myo->_index + 1 : 0; }
+
+    std::vector<Slot> _slots;
+};
+
+} // namespace myo
+
+#endif // MYO_CXX_DETAIL_MYOTRACKS_HPP
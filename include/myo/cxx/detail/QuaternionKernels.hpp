@@ -0,0 +1,204 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+
+// Batch kernels for QuaternionArray and Vector3Array, written once against a pack type from SimdPack.hpp.
+// This file is deliberately included several times, each time inside a namespace that defines Pack as one of the
+// pack types, and therefore has no include guard. Each kernel processes elements [begin, end), and end - begin must
+// be a multiple of Pack::width. Outputs may alias inputs.
+
+inline void multiplyQuaternions(const float* const* a, const float* const* b, float* const* out,
+                                std::size_t begin, std::size_t end)
+{
+    typedef Pack::type V;
+    for (std::size_t i = begin; i < end; i += Pack::width) {
+        V ax = Pack::load(a[0] + i), ay = Pack::load(a[1] + i), az = Pack::load(a[2] + i), aw = Pack::load(a[3] + i);
+        V bx = Pack::load(b[0] + i), by = Pack::load(b[1] + i), bz = Pack::load(b[2] + i), bw = Pack::load(b[3] + i);
+
+        V x = Pack::sub(Pack::fmadd(aw, bx, Pack::fmadd(ax, bw, Pack::mul(ay, bz))), Pack::mul(az, by));
+        V y = Pack::sub(Pack::fmadd(aw, by, Pack::fmadd(ay, bw, Pack::mul(az, bx))), Pack::mul(ax, bz));
+        V z = Pack::sub(Pack::fmadd(aw, bz, Pack::fmadd(ax, by, Pack::mul(az, bw))), Pack::mul(ay, bx));
+        V w = Pack::sub(Pack::mul(aw, bw), Pack::fmadd(ax, bx, Pack::fmadd(ay, by, Pack::mul(az, bz))));
+
+        Pack::store(out[0] + i, x);
+        Pack::store(out[1] + i, y);
+        Pack::store(out[2] + i, z);
+        Pack::store(out[3] + i, w);
+    }
+}
+
+inline void normalizeQuaternions(const float* const* q, float* const* out, std::size_t begin, std::size_t end)
+{
+    typedef Pack::type V;
+    for (std::size_t i = begin; i < end; i += Pack::width) {
+        V x = Pack::load(q[0] + i), y = Pack::load(q[1] + i), z = Pack::load(q[2] + i), w = Pack::load(q[3] + i);
+        V magnitude = Pack::sqrt(Pack::fmadd(x, x, Pack::fmadd(y, y, Pack::fmadd(z, z, Pack::mul(w, w)))));
+
+        Pack::store(out[0] + i, Pack::div(x, magnitude));
+        Pack::store(out[1] + i, Pack::div(y, magnitude));
+        Pack::store(out[2] + i, Pack::div(z, magnitude));
+        Pack::store(out[3] + i, Pack::div(w, magnitude));
+    }
+}
+
+inline void conjugateQuaternions(const float* const* q, float* const* out, std::size_t begin, std::size_t end)
+{
+    for (std::size_t i = begin; i < end; i += Pack::width) {
+        Pack::store(out[0] + i, Pack::neg(Pack::load(q[0] + i)));
+        Pack::store(out[1] + i, Pack::neg(Pack::load(q[1] + i)));
+        Pack::store(out[2] + i, Pack::neg(Pack::load(q[2] + i)));
+        Pack::store(out[3] + i, Pack::load(q[3] + i));
+    }
+}
+
+// Rotates with v' = v + w * t + u x t, where u is the vector part of the unit quaternion and t = 2 * (u x v).
+inline void rotateVectors(const float* const* q, const float* const* v, float* const* out,
+                          std::size_t begin, std::size_t end)
+{
+    typedef Pack::type V;
+    const V two = Pack::set1(2.0f);
+    for (std::size_t i = begin; i < end; i += Pack::width) {
+        V qx = Pack::load(q[0] + i), qy = Pack::load(q[1] + i), qz = Pack::load(q[2] + i), qw = Pack::load(q[3] + i);
+        V vx = Pack::load(v[0] + i), vy = Pack::load(v[1] + i), vz = Pack::load(v[2] + i);
+
+        V tx = Pack::mul(two, Pack::sub(Pack::mul(qy, vz), Pack::mul(qz, vy)));
+        V ty = Pack::mul(two, Pack::sub(Pack::mul(qz, vx), Pack::mul(qx, vz)));
+        V tz = Pack::mul(two, Pack::sub(Pack::mul(qx, vy), Pack::mul(qy, vx)));
+
+        Pack::store(out[0] + i, Pack::add(Pack::fmadd(qw, tx, vx), Pack::sub(Pack::mul(qy, tz), Pack::mul(qz, ty))));
+        Pack::store(out[1] + i, Pack::add(Pack::fmadd(qw, ty, vy), Pack::sub(Pack::mul(qz, tx), Pack::mul(qx, tz))));
+        Pack::store(out[2] + i, Pack::add(Pack::fmadd(qw, tz, vz), Pack::sub(Pack::mul(qx, ty), Pack::mul(qy, tx))));
+    }
+}
+
+// \a from and \a to hold the slerpCoefficients() for 1 - t and t respectively; \a s is 1 - t.
+inline void slerpQuaternions(const float* const* a, const float* const* b, float* const* out,
+                             const float* from, const float* to, float s, float t,
+                             std::size_t begin, std::size_t end)
+{
+    typedef Pack::type V;
+    const V one = Pack::set1(1.0f);
+    for (std::size_t i = begin; i < end; i += Pack::width) {
+        V ax = Pack::load(a[0] + i), ay = Pack::load(a[1] + i), az = Pack::load(a[2] + i), aw = Pack::load(a[3] + i);
+        V bx = Pack::load(b[0] + i), by = Pack::load(b[1] + i), bz = Pack::load(b[2] + i), bw = Pack::load(b[3] + i);
+
+        // Take the shorter arc by flipping \a b when the quaternions point into opposite hemispheres.
+        V cosine = Pack::fmadd(ax, bx, Pack::fmadd(ay, by, Pack::fmadd(az, bz, Pack::mul(aw, bw))));
+        bx = Pack::flipSign(bx, cosine);
+        by = Pack::flipSign(by, cosine);
+        bz = Pack::flipSign(bz, cosine);
+        bw = Pack::flipSign(bw, cosine);
+        V y = Pack::sub(Pack::abs(cosine), one);
+
+        V f0 = Pack::set1(from[slerpTerms - 1]);
+        V f1 = Pack::set1(to[slerpTerms - 1]);
+        for (int k = slerpTerms - 2; k >= 0; --k) {
+            f0 = Pack::fmadd(f0, y, Pack::set1(from[k]));
+            f1 = Pack::fmadd(f1, y, Pack::set1(to[k]));
+        }
+        f0 = Pack::mul(f0, Pack::set1(s));
+        f1 = Pack::mul(f1, Pack::set1(t));
+
+        Pack::store(out[0] + i, Pack::fmadd(f0, ax, Pack::mul(f1, bx)));
+        Pack::store(out[1] + i, Pack::fmadd(f0, ay, Pack::mul(f1, by)));
+        Pack::store(out[2] + i, Pack::fmadd(f0, az, Pack::mul(f1, bz)));
+        Pack::store(out[3] + i, Pack::fmadd(f0, aw, Pack::mul(f1, bw)));
+    }
+}
+
+inline void normalizeVectors(const float* const* v, float* const* out, std::size_t begin, std::size_t end)
+{
+    typedef Pack::type V;
+    for (std::size_t i = begin; i < end; i += Pack::width) {
+        V x = Pack::load(v[0] + i), y = Pack::load(v[1] + i), z = Pack::load(v[2] + i);
+        V magnitude = Pack::sqrt(Pack::fmadd(x, x, Pack::fmadd(y, y, Pack::mul(z, z))));
+
+        Pack::store(out[0] + i, Pack::div(x, magnitude));
+        Pack::store(out[1] + i, Pack::div(y, magnitude));
+        Pack::store(out[2] + i, Pack::div(z, magnitude));
+    }
+}
+
+// Return atan2(y, x). The arctangent of the ratio of the smaller to the larger magnitude, which lies in [0, 1], is
+// evaluated with a minimax polynomial whose error is below 4e-8 radians; the result is then moved to its octant.
+inline Pack::type atan2Approx(Pack::type y, Pack::type x)
+{
+    typedef Pack::type V;
+    V absX = Pack::abs(x);
+    V absY = Pack::abs(y);
+    V ratio = Pack::div(Pack::min(absX, absY), Pack::max(Pack::max(absX, absY), Pack::set1(1.17549435e-38f)));
+    V s = Pack::mul(ratio, ratio);
+
+    V r = Pack::set1(-0.00405505967f);
+    r = Pack::fmadd(r, s, Pack::set1(0.0218648419f));
+    r = Pack::fmadd(r, s, Pack::set1(-0.0559152245f));
+    r = Pack::fmadd(r, s, Pack::set1(0.0964242599f));
+    r = Pack::fmadd(r, s, Pack::set1(-0.139087273f));
+    r = Pack::fmadd(r, s, Pack::set1(0.199465875f));
+    r = Pack::fmadd(r, s, Pack::set1(-0.33329863f));
+    r = Pack::fmadd(r, s, Pack::set1(0.999999336f));
+    r = Pack::mul(r, ratio);
+
+    r = Pack::select(Pack::greater(absY, absX), Pack::sub(Pack::set1(1.57079633f), r), r);
+    r = Pack::select(Pack::greater(Pack::set1(0.0f), x), Pack::sub(Pack::set1(3.14159265f), r), r);
+    return Pack::flipSign(r, y);
+}
+
+// Compute roll, pitch and yaw for the same rotation convention as Quaternion. Pitch is computed as atan2(sin, cos)
+// rather than with an arcsine so that it can share atan2Approx().
+inline void eulerAngles(Pack::type x, Pack::type y, Pack::type z, Pack::type w,
+                        Pack::type& roll, Pack::type& pitch, Pack::type& yaw)
+{
+    typedef Pack::type V;
+    const V one = Pack::set1(1.0f);
+    const V two = Pack::set1(2.0f);
+
+    roll = atan2Approx(Pack::mul(two, Pack::fmadd(w, x, Pack::mul(y, z))),
+                       Pack::sub(one, Pack::mul(two, Pack::fmadd(x, x, Pack::mul(y, y)))));
+    V sinPitch = Pack::mul(two, Pack::sub(Pack::mul(w, y), Pack::mul(z, x)));
+    sinPitch = Pack::max(Pack::set1(-1.0f), Pack::min(one, sinPitch));
+    V cosPitch = Pack::sqrt(Pack::max(Pack::set1(0.0f), Pack::sub(one, Pack::mul(sinPitch, sinPitch))));
+    pitch = atan2Approx(sinPitch, cosPitch);
+    yaw = atan2Approx(Pack::mul(two, Pack::fmadd(w, z, Pack::mul(x, y))),
+                      Pack::sub(one, Pack::mul(two, Pack::fmadd(y, y, Pack::mul(z, z)))));
+}
+
+// Store roll, pitch and yaw in out[0], out[1] and out[2].
+inline void eulerAngles(const float* const* q, float* const* out, std::size_t begin, std::size_t end)
+{
+    typedef Pack::type V;
+    for (std::size_t i = begin; i < end; i += Pack::width) {
+        V roll, pitch, yaw;
+        eulerAngles(Pack::load(q[0] + i), Pack::load(q[1] + i), Pack::load(q[2] + i), Pack::load(q[3] + i),
+                    roll, pitch, yaw);
+
+        Pack::store(out[0] + i, roll);
+        Pack::store(out[1] + i, pitch);
+        Pack::store(out[2] + i, yaw);
+    }
+}
+
+// Store roll, pitch and yaw quantized to \a buckets equal steps in out[0], out[1] and out[2]. Roll and yaw are
+// bucketed over [-pi, pi] and pitch over [-pi / 2, pi / 2].
+inline void eulerBuckets(const float* const* q, int* const* out, float buckets, std::size_t begin, std::size_t end)
+{
+    typedef Pack::type V;
+    const V zero = Pack::set1(0.0f);
+    const V last = Pack::set1(buckets - 1);
+    const V halfTurn = Pack::set1(3.14159265f);
+    const V quarterTurn = Pack::set1(1.57079633f);
+    const V perTurn = Pack::set1(buckets / 6.28318531f);
+    const V perHalfTurn = Pack::set1(buckets / 3.14159265f);
+    for (std::size_t i = begin; i < end; i += Pack::width) {
+        V roll, pitch, yaw;
+        eulerAngles(Pack::load(q[0] + i), Pack::load(q[1] + i), Pack::load(q[2] + i), Pack::load(q[3] + i),
+                    roll, pitch, yaw);
+
+        roll = Pack::mul(Pack::add(roll, halfTurn), perTurn);
+        pitch = Pack::mul(Pack::add(pitch, quarterTurn), perHalfTurn);
+        yaw = Pack::mul(Pack::add(yaw, halfTurn), perTurn);
+
+        Pack::storeInt(out[0] + i, Pack::min(last, Pack::max(zero, roll)));
+        Pack::storeInt(out[1] + i, Pack::min(last, Pack::max(zero, pitch)));
+        Pack::storeInt(out[2] + i, Pack::min(last, Pack::max(zero, yaw)));
+    }
+}
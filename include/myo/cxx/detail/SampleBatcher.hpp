@@ -0,0 +1,125 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_CXX_DETAIL_SAMPLEBATCHER_HPP
+#define MYO_CXX_DETAIL_SAMPLEBATCHER_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "../DeviceEvent.hpp"
+#include "../DeviceListener.hpp"
+
+namespace myo {
+
+class Myo;
+
+/// Accumulates the EMG and IMU samples of one Myo into fixed-size structure-of-arrays blocks.
+class SampleBatcher {
+public:
+    SampleBatcher()
+    : _myo(0)
+    , _capacity(0)
+    , _emgSize(0)
+    , _imuSize(0)
+    {
+    }
+
+    /// Discard any pending samples and make room for \a capacity samples of each kind from \a myo.
+    void reset(Myo* myo, std::size_t capacity)
+    {
+        _myo = myo;
+        _capacity = capacity;
+        _emgSize = 0;
+        _imuSize = 0;
+        _emgTimestamps.resize(capacity);
+        _emg.resize(capacity * 8);
+        _imuTimestamps.resize(capacity);
+        _imu.resize(capacity * 10);
+    }
+
+    /// Return the Myo whose samples are being accumulated, or null if reset() has not been called.
+    Myo* myo() const { return _myo; }
+
+    std::size_t capacity() const { return _capacity; }
+
+    /// Append an EMG sample. Return true if the EMG batch is now full.
+    bool addEmg(uint64_t timestamp, const int8_t* emg)
+    {
+        _emgTimestamps[_emgSize] = timestamp;
+        for (std::size_t c = 0; c < 8; ++c) {
+            _emg[c * _capacity + _emgSize] = emg[c];
+        }
+        return ++_emgSize == _capacity;
+    }
+
+    /// Append an IMU sample. Return true if the IMU batch is now full.
+    bool addImu(uint64_t timestamp, const DeviceEvent::Imu& imu)
+    {
+        _imuTimestamps[_imuSize] = timestamp;
+        float* column = &_imu[_imuSize];
+        for (std::size_t c = 0; c < 4; ++c, column += _capacity) {
+            *column = imu.orientation[c];
+        }
+        for (std::size_t c = 0; c < 3; ++c, column += _capacity) {
+            *column = imu.accelerometer[c];
+        }
+        for (std::size_t c = 0; c < 3; ++c, column += _capacity) {
+            *column = imu.gyroscope[c];
+        }
+        return ++_imuSize == _capacity;
+    }
+
+    std::size_t emgSize() const { return _emgSize; }
+    std::size_t imuSize() const { return _imuSize; }
+
+    /// Return a view of the pending EMG samples and mark them as consumed.
+    /// The view remains valid until the next call to addEmg() or reset().
+    EmgBatch takeEmg()
+    {
+        EmgBatch batch;
+        batch.size = _emgSize;
+        batch.timestamps = &_emgTimestamps[0];
+        for (std::size_t c = 0; c < 8; ++c) {
+            batch.channels[c] = &_emg[c * _capacity];
+        }
+        _emgSize = 0;
+        return batch;
+    }
+
+    /// Return a view of the pending IMU samples and mark them as consumed.
+    /// The view remains valid until the next call to addImu() or reset().
+    ImuBatch takeImu()
+    {
+        ImuBatch batch;
+        batch.size = _imuSize;
+        batch.timestamps = &_imuTimestamps[0];
+        const float* column = &_imu[0];
+        for (std::size_t c = 0; c < 4; ++c, column += _capacity) {
+            batch.orientation[c] = column;
+        }
+        for (std::size_t c = 0; c < 3; ++c, column += _capacity) {
+            batch.accelerometer[c] = column;
+        }
+        for (std::size_t c = 0; c < 3; ++c, column += _capacity) {
+            batch.gyroscope[c] = column;
+        }
+        _imuSize = 0;
+        return batch;
+    }
+
+private:
+    Myo* _myo;
+    std::size_t _capacity;
+    std::size_t _emgSize;
+    std::size_t _imuSize;
+
+    // Channel-major: channel c occupies [c * _capacity, (c + 1) * _capacity).
+    std::vector<uint64_t> _emgTimestamps;
+    std::vector<int8_t> _emg;
+    std::vector<uint64_t> _imuTimestamps;
+    std::vector<float> _imu;
+};
+
+} // namespace myo
+
+#endif // MYO_CXX_DETAIL_SAMPLEBATCHER_HPP
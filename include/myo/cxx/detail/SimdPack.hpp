@@ -0,0 +1,163 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_CXX_DETAIL_SIMDPACK_HPP
+#define MYO_CXX_DETAIL_SIMDPACK_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+// Kernels are written once against the pack types below, which wrap a register of \a width floats together with the
+// handful of operations the kernels need. Instruction sets beyond the compiler's baseline are enabled for individual
+// functions only, so that a single binary can pick the widest supported path at run time.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define MYO_SIMD_X86 1
+# include <emmintrin.h>
+# include <immintrin.h>
+# if defined(_MSC_VER)
+#  include <intrin.h>
+# endif
+#endif
+
+namespace myo {
+namespace simd {
+
+/// Instruction set levels for batch math, in increasing order of width.
+enum Level {
+    levelScalar = 0, ///< Portable C++, one element at a time.
+    levelSse2   = 1, ///< 4 floats per instruction.
+    levelAvx2   = 2  ///< 8 floats per instruction, with fused multiply-add.
+};
+
+struct ScalarPack {
+    typedef float type;
+    typedef bool mask;
+    enum { width = 1 };
+
+    static type load(const float* p) { return *p; }
+    static void store(float* p, type v) { *p = v; }
+    static type set1(float v) { return v; }
+    static type add(type a, type b) { return a + b; }
+    static type sub(type a, type b) { return a - b; }
+    static type mul(type a, type b) { return a * b; }
+    static type div(type a, type b) { return a / b; }
+    static type fmadd(type a, type b, type c) { return a * b + c; }
+    static type neg(type a) { return -a; }
+    static type abs(type a) { return std::fabs(a); }
+    static type sqrt(type a) { return std::sqrt(a); }
+    static type flipSign(type a, type sign)
+    {
+        // Test the sign bit like the vector packs do, so that -0 flips \a a as well.
+        unsigned int bits;
+        std::memcpy(&bits, &sign, sizeof(bits));
+        return bits >> 31 ? -a : a;
+    }
+    static type min(type a, type b) { return a < b ? a : b; }
+    static type max(type a, type b) { return a > b ? a : b; }
+    static mask greater(type a, type b) { return a > b; }
+    static type select(mask m, type a, type b) { return m ? a : b; }
+    static void storeInt(int* p, type v) { *p = static_cast<int>(v); }
+};
+
+#if defined(MYO_SIMD_X86)
+
+struct Sse2Pack {
+    typedef __m128 type;
+    typedef __m128 mask;
+    enum { width = 4 };
+
+    static type load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, type v) { _mm_storeu_ps(p, v); }
+    static type set1(float v) { return _mm_set1_ps(v); }
+    static type add(type a, type b) { return _mm_add_ps(a, b); }
+    static type sub(type a, type b) { return _mm_sub_ps(a, b); }
+    static type mul(type a, type b) { return _mm_mul_ps(a, b); }
+    static type div(type a, type b) { return _mm_div_ps(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static type neg(type a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+    static type abs(type a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static type sqrt(type a) { return _mm_sqrt_ps(a); }
+    static type flipSign(type a, type sign) { return _mm_xor_ps(a, _mm_and_ps(sign, _mm_set1_ps(-0.0f))); }
+    static type min(type a, type b) { return _mm_min_ps(a, b); }
+    static type max(type a, type b) { return _mm_max_ps(a, b); }
+    static mask greater(type a, type b) { return _mm_cmpgt_ps(a, b); }
+    static type select(mask m, type a, type b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    static void storeInt(int* p, type v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm_cvttps_epi32(v)); }
+};
+
+#if defined(__clang__)
+# pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+# pragma GCC push_options
+# pragma GCC target("avx2,fma")
+#endif
+
+struct Avx2Pack {
+    typedef __m256 type;
+    typedef __m256 mask;
+    enum { width = 8 };
+
+    static type load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, type v) { _mm256_storeu_ps(p, v); }
+    static type set1(float v) { return _mm256_set1_ps(v); }
+    static type add(type a, type b) { return _mm256_add_ps(a, b); }
+    static type sub(type a, type b) { return _mm256_sub_ps(a, b); }
+    static type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+    static type div(type a, type b) { return _mm256_div_ps(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm256_fmadd_ps(a, b, c); }
+    static type neg(type a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    static type abs(type a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static type sqrt(type a) { return _mm256_sqrt_ps(a); }
+    static type flipSign(type a, type sign) { return _mm256_xor_ps(a, _mm256_and_ps(sign, _mm256_set1_ps(-0.0f))); }
+    static type min(type a, type b) { return _mm256_min_ps(a, b); }
+    static type max(type a, type b) { return _mm256_max_ps(a, b); }
+    static mask greater(type a, type b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static type select(mask m, type a, type b) { return _mm256_blendv_ps(b, a, m); }
+    static void storeInt(int* p, type v)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm256_cvttps_epi32(v));
+    }
+};
+
+#if defined(__clang__)
+# pragma clang attribute pop
+#elif defined(__GNUC__)
+# pragma GCC pop_options
+#endif
+
+#endif // MYO_SIMD_X86
+
+/// Return the widest instruction set level supported by the processor and operating system.
+inline Level detectLevel()
+{
+#if defined(MYO_SIMD_X86)
+# if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    if (osxsave && avx && fma && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 5)) {
+            return levelAvx2;
+        }
+    }
+    return levelSse2;
+# else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return levelAvx2;
+    }
+    return levelSse2;
+# endif
+#else
+    return levelScalar;
+#endif
+}
+
+} // namespace simd
+} // namespace myo
+
+#endif // MYO_CXX_DETAIL_SIMDPACK_HPP
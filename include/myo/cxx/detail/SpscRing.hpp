@@ -0,0 +1,126 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_CXX_DETAIL_SPSCRING_HPP
+#define MYO_CXX_DETAIL_SPSCRING_HPP
+
+// SpscRing requires C++11 atomics.
+
+#include <stdint.h>
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace myo {
+
+/// A bounded, lock-free single-producer/single-consumer ring of values of type T, shared by EventQueue and HubGroup.
+/// When the ring is full, push() fails and the value is counted as dropped rather than blocking the producer.
+template<typename T>
+class SpscRing {
+public:
+    /// Construct a ring holding up to \a capacity values. \a capacity is rounded up to a power of two.
+    explicit SpscRing(std::size_t capacity)
+    : _buffer(roundUpToPowerOfTwo(capacity))
+    , _mask(_buffer.size() - 1)
+    , _head(0)
+    , _tail(0)
+    , _dropped(0)
+    {
+    }
+
+    /// Append \a value. Must only be called from the producer thread.
+    /// Return false, and count the value as dropped, if the ring is full. Otherwise set \a size to the number of
+    /// values now waiting, including \a value.
+    bool push(const T& value, std::size_t& size)
+    {
+        const std::size_t head = _head.load(std::memory_order_relaxed);
+        size = head - _tail.load(std::memory_order_acquire);
+        if (size > _mask) {
+            _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        _buffer[head & _mask] = value;
+        _head.store(head + 1, std::memory_order_release);
+        ++size;
+        return true;
+    }
+
+    bool push(const T& value)
+    {
+        std::size_t size;
+        return push(value, size);
+    }
+
+    /// Hand up to \a maxValues of the oldest values to \a consumer, oldest first. Must only be called from the
+    /// consumer thread. The values are handed over in place, and their slots are only released to the producer once
+    /// all of them have been consumed. Return the number of values consumed.
+    template<typename Consumer>
+    std::size_t consume(Consumer consumer, std::size_t maxValues)
+    {
+        const std::size_t tail = _tail.load(std::memory_order_relaxed);
+        std::size_t count = _head.load(std::memory_order_acquire) - tail;
+        if (count > maxValues) {
+            count = maxValues;
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            consumer(static_cast<const T&>(_buffer[(tail + i) & _mask]));
+        }
+
+        _tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /// Move the oldest value into \a value. Must only be called from the consumer thread.
+    /// Return false if the ring is empty.
+    bool pop(T& value)
+    {
+        return consume([&value](const T& oldest) { value = oldest; }, 1) == 1;
+    }
+
+    /// Return the maximum number of values the ring can hold.
+    std::size_t capacity() const { return _buffer.size(); }
+
+    /// Return the number of values currently waiting. The value may be stale by the time it is used.
+    std::size_t size() const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    /// Return the number of values that were discarded because the ring was full.
+    uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    static std::size_t roundUpToPowerOfTwo(std::size_t n)
+    {
+        std::size_t result = 1;
+        while (result < n) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // Padding keeps the producer- and consumer-owned indices on separate cache lines.
+    enum { cacheLineSize = 64 };
+
+    std::vector<T> _buffer;
+    const std::size_t _mask;
+
+    char _pad0[cacheLineSize];
+    std::atomic<std::size_t> _head;
+    char _pad1[cacheLineSize - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> _tail;
+    char _pad2[cacheLineSize - sizeof(std::atomic<std::size_t>)];
+
+    // Written by the producer only.
+    std::atomic<uint64_t> _dropped;
+
+    // Not implemented
+    SpscRing(const SpscRing&); // = delete;
+    SpscRing& operator=(const SpscRing&); // = delete;
+};
+
+} // namespace myo
+
+#endif // MYO_CXX_DETAIL_SPSCRING_HPP
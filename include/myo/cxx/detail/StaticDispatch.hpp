@@ -0,0 +1,277 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_CXX_DETAIL_STATICDISPATCH_HPP
+#define MYO_CXX_DETAIL_STATICDISPATCH_HPP
+
+// Compile-time callback detection for StaticHub. Requires C++11.
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <myo/libmyo.h>
+
+#include "../DeviceListener.hpp"
+#include "../Pose.hpp"
+#include "../Quaternion.hpp"
+#include "../Vector3.hpp"
+
+namespace myo {
+
+class Myo;
+
+/// Tags standing for the DeviceListener callbacks. Each tag lists the callback's parameter types and forwards call()
+/// to the member function of the same name; call() only exists for listener types that can be called that way.
+namespace callback {
+
+struct OnPair {
+    typedef void Arguments(Myo*, uint64_t, FirmwareVersion);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp, FirmwareVersion firmwareVersion)
+        -> decltype(listener.onPair(myo, timestamp, firmwareVersion))
+    {
+        return listener.onPair(myo, timestamp, firmwareVersion);
+    }
+};
+
+struct OnUnpair {
+    typedef void Arguments(Myo*, uint64_t);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp) -> decltype(listener.onUnpair(myo, timestamp))
+    {
+        return listener.onUnpair(myo, timestamp);
+    }
+};
+
+struct OnConnect {
+    typedef void Arguments(Myo*, uint64_t, FirmwareVersion);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp, FirmwareVersion firmwareVersion)
+        -> decltype(listener.onConnect(myo, timestamp, firmwareVersion))
+    {
+        return listener.onConnect(myo, timestamp, firmwareVersion);
+    }
+};
+
+struct OnDisconnect {
+    typedef void Arguments(Myo*, uint64_t);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp) -> decltype(listener.onDisconnect(myo, timestamp))
+    {
+        return listener.onDisconnect(myo, timestamp);
+    }
+};
+
+struct OnArmSync {
+    typedef void Arguments(Myo*, uint64_t, Arm, XDirection, float, WarmupState);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp, Arm arm, XDirection xDirection, float rotation,
+                     WarmupState warmupState)
+        -> decltype(listener.onArmSync(myo, timestamp, arm, xDirection, rotation, warmupState))
+    {
+        return listener.onArmSync(myo, timestamp, arm, xDirection, rotation, warmupState);
+    }
+};
+
+struct OnArmUnsync {
+    typedef void Arguments(Myo*, uint64_t);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp) -> decltype(listener.onArmUnsync(myo, timestamp))
+    {
+        return listener.onArmUnsync(myo, timestamp);
+    }
+};
+
+struct OnUnlock {
+    typedef void Arguments(Myo*, uint64_t);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp) -> decltype(listener.onUnlock(myo, timestamp))
+    {
+        return listener.onUnlock(myo, timestamp);
+    }
+};
+
+struct OnLock {
+    typedef void Arguments(Myo*, uint64_t);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp) -> decltype(listener.onLock(myo, timestamp))
+    {
+        return listener.onLock(myo, timestamp);
+    }
+};
+
+struct OnPose {
+    typedef void Arguments(Myo*, uint64_t, Pose);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp, Pose pose)
+        -> decltype(listener.onPose(myo, timestamp, pose))
+    {
+        return listener.onPose(myo, timestamp, pose);
+    }
+};
+
+struct OnOrientationData {
+    typedef void Arguments(Myo*, uint64_t, const Quaternion<float>&);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation)
+        -> decltype(listener.onOrientationData(myo, timestamp, rotation))
+    {
+        return listener.onOrientationData(myo, timestamp, rotation);
+    }
+};
+
+struct OnAccelerometerData {
+    typedef void Arguments(Myo*, uint64_t, const Vector3<float>&);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp, const Vector3<float>& accel)
+        -> decltype(listener.onAccelerometerData(myo, timestamp, accel))
+    {
+        return listener.onAccelerometerData(myo, timestamp, accel);
+    }
+};
+
+struct OnGyroscopeData {
+    typedef void Arguments(Myo*, uint64_t, const Vector3<float>&);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp, const Vector3<float>& gyro)
+        -> decltype(listener.onGyroscopeData(myo, timestamp, gyro))
+    {
+        return listener.onGyroscopeData(myo, timestamp, gyro);
+    }
+};
+
+struct OnRssi {
+    typedef void Arguments(Myo*, uint64_t, int8_t);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp, int8_t rssi)
+        -> decltype(listener.onRssi(myo, timestamp, rssi))
+    {
+        return listener.onRssi(myo, timestamp, rssi);
+    }
+};
+
+struct OnBatteryLevelReceived {
+    typedef void Arguments(Myo*, uint64_t, uint8_t);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp, uint8_t level)
+        -> decltype(listener.onBatteryLevelReceived(myo, timestamp, level))
+    {
+        return listener.onBatteryLevelReceived(myo, timestamp, level);
+    }
+};
+
+struct OnEmgData {
+    typedef void Arguments(Myo*, uint64_t, const int8_t*);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp, const int8_t* emg)
+        -> decltype(listener.onEmgData(myo, timestamp, emg))
+    {
+        return listener.onEmgData(myo, timestamp, emg);
+    }
+};
+
+struct OnWarmupCompleted {
+    typedef void Arguments(Myo*, uint64_t, WarmupResult);
+    template<typename L>
+    static auto call(L& listener, Myo* myo, uint64_t timestamp, WarmupResult warmupResult)
+        -> decltype(listener.onWarmupCompleted(myo, timestamp, warmupResult))
+    {
+        return listener.onWarmupCompleted(myo, timestamp, warmupResult);
+    }
+};
+
+struct OnOpaqueEvent {
+    typedef void Arguments(libmyo_event_t);
+    template<typename L>
+    static auto call(L& listener, libmyo_event_t event) -> decltype(listener.onOpaqueEvent(event))
+    {
+        return listener.onOpaqueEvent(event);
+    }
+};
+
+/// True if \a Tag's callback can be called on a listener of type \a L.
+template<typename Tag, typename L, typename Arguments = typename Tag::Arguments>
+struct Handles;
+
+template<typename Tag, typename L, typename... Args>
+struct Handles<Tag, L, void(Args...)> {
+private:
+    template<typename T>
+    static std::true_type test(decltype(Tag::call(std::declval<T&>(), std::declval<Args>()...), void())*);
+    template<typename T>
+    static std::false_type test(...);
+
+public:
+    static const bool value = decltype(test<L>(0))::value;
+};
+
+/// True if any of the listener types \a Ls handles \a Tag.
+template<typename Tag, typename... Ls>
+struct HandledByAny : std::false_type {};
+
+template<typename Tag, typename L, typename... Ls>
+struct HandledByAny<Tag, L, Ls...>
+    : std::integral_constant<bool, Handles<Tag, L>::value || HandledByAny<Tag, Ls...>::value> {};
+
+template<typename Tag, typename L, typename... Args>
+inline void invokeIf(std::true_type, L& listener, const Args&... args)
+{
+    Tag::call(listener, args...);
+}
+
+template<typename Tag, typename L, typename... Args>
+inline void invokeIf(std::false_type, L&, const Args&...)
+{
+}
+
+/// Call \a Tag's callback on every listener in \a listeners, a tuple of references, that handles it.
+template<std::size_t Index, std::size_t Count>
+struct ForEach {
+    template<typename Tag, typename Tuple, typename... Args>
+    static void invoke(Tuple& listeners, const Args&... args)
+    {
+        typedef typename std::remove_reference<typename std::tuple_element<Index, Tuple>::type>::type L;
+        invokeIf<Tag>(std::integral_constant<bool, Handles<Tag, L>::value>(), std::get<Index>(listeners), args...);
+        ForEach<Index + 1, Count>::template invoke<Tag>(listeners, args...);
+    }
+
+    /// Call the orientation, accelerometer and gyroscope callbacks of one IMU sample on each listener in turn, so
+    /// that a listener sees all three before the next listener sees any, as with Hub.
+    template<typename Tuple>
+    static void invokeImu(Tuple& listeners, Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation,
+                          const Vector3<float>& accel, const Vector3<float>& gyro)
+    {
+        typedef typename std::remove_reference<typename std::tuple_element<Index, Tuple>::type>::type L;
+        L& listener = std::get<Index>(listeners);
+        invokeIf<OnOrientationData>(std::integral_constant<bool, Handles<OnOrientationData, L>::value>(), listener,
+                                    myo, timestamp, rotation);
+        invokeIf<OnAccelerometerData>(std::integral_constant<bool, Handles<OnAccelerometerData, L>::value>(),
+                                      listener, myo, timestamp, accel);
+        invokeIf<OnGyroscopeData>(std::integral_constant<bool, Handles<OnGyroscopeData, L>::value>(), listener,
+                                  myo, timestamp, gyro);
+        ForEach<Index + 1, Count>::invokeImu(listeners, myo, timestamp, rotation, accel, gyro);
+    }
+};
+
+template<std::size_t Count>
+struct ForEach<Count, Count> {
+    template<typename Tag, typename Tuple, typename... Args>
+    static void invoke(Tuple&, const Args&...)
+    {
+    }
+
+    template<typename Tuple>
+    static void invokeImu(Tuple&, Myo*, uint64_t, const Quaternion<float>&, const Vector3<float>&,
+                          const Vector3<float>&)
+    {
+    }
+};
+
+} // namespace callback
+
+} // namespace myo
+
+#endif // MYO_CXX_DETAIL_STATICDISPATCH_HPP
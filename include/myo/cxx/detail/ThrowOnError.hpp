@@ -3,10 +3,15 @@
 #ifndef MYO_CXX_DETAIL_THROWONERROR_HPP
 #define MYO_CXX_DETAIL_THROWONERROR_HPP
 
+#include <cstdio>
+#include <cstdlib>
 #include <stdexcept>
+#include <string>
 
 #include <myo/libmyo.h>
 
+#include "../ErrorCode.hpp"
+
 #if defined(_MSC_VER) && _MSC_VER <= 1800
 #define LIBMYO_NOEXCEPT(b)
 #else
@@ -17,8 +22,38 @@
 #endif
 #endif
 
+// Code built without exception support can still include the wrapper; failures that would throw abort instead, and
+// the ErrorCode overloads should be used to handle them.
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+# define LIBMYO_EXCEPTIONS 1
+#else
+# define LIBMYO_EXCEPTIONS 0
+#endif
+
 namespace myo {
 
+// Throw std::invalid_argument or std::runtime_error, according to \a kind, with \a message.
+inline void throwError(libmyo_result_t kind, const char* message)
+{
+#if LIBMYO_EXCEPTIONS
+    if (kind == libmyo_error_invalid_argument) {
+        throw std::invalid_argument(message);
+    }
+    throw std::runtime_error(message);
+#else
+    std::fprintf(stderr, "myo: %s\n", message);
+    std::abort();
+#endif
+}
+
+// Throw as throwError() does if \a error indicates a failure.
+inline void throwIfFailed(const ErrorCode& error)
+{
+    if (error.failed()) {
+        throwError(error.kind(), error.message());
+    }
+}
+
 class ThrowOnError {
 public:
     ThrowOnError()
@@ -28,26 +63,12 @@ public:
 
     ~ThrowOnError() LIBMYO_NOEXCEPT(false)
     {
-        if (_error)
-        {
-            switch (libmyo_error_kind(_error)) {
-            case libmyo_error:
-            case libmyo_error_runtime:
-            {
-                std::runtime_error exception(libmyo_error_cstring(_error));
+        if (_error) {
+            libmyo_result_t kind = libmyo_error_kind(_error);
+            if (kind != libmyo_success) {
+                std::string message(libmyo_error_cstring(_error));
                 libmyo_free_error_details(_error);
-                throw exception;
-            }
-            case libmyo_error_invalid_argument:
-            {
-                std::invalid_argument exception(libmyo_error_cstring(_error));
-                libmyo_free_error_details(_error);
-                throw exception;
-            }
-            case libmyo_success:
-            {
-                break;
-            }
+                throwError(kind, message.c_str());
             }
         }
     }
@@ -0,0 +1,31 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_CXX_DETAIL_WINDOWS_HPP
+#define MYO_CXX_DETAIL_WINDOWS_HPP
+
+// Include <windows.h> for the headers that call into Win32 without leaving its min and max macros behind, which
+// would break std::min(), std::max() and std::numeric_limits<T>::max() in the headers that follow. The macros this
+// header defines to that end are removed again, so including it does not change how the user's own code sees
+// <windows.h>.
+
+#if defined(_WIN32)
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#  define MYO_CXX_DEFINED_WIN32_LEAN_AND_MEAN
+# endif
+# ifndef NOMINMAX
+#  define NOMINMAX
+#  define MYO_CXX_DEFINED_NOMINMAX
+# endif
+# include <windows.h>
+# ifdef MYO_CXX_DEFINED_WIN32_LEAN_AND_MEAN
+#  undef WIN32_LEAN_AND_MEAN
+#  undef MYO_CXX_DEFINED_WIN32_LEAN_AND_MEAN
+# endif
+# ifdef MYO_CXX_DEFINED_NOMINMAX
+#  undef NOMINMAX
+#  undef MYO_CXX_DEFINED_NOMINMAX
+# endif
+#endif
+
+#endif // MYO_CXX_DETAIL_WINDOWS_HPP
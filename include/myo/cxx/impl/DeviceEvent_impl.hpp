@@ -0,0 +1,141 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#include "../DeviceEvent.hpp"
+
+#include "../Quaternion.hpp"
+#include "../Vector3.hpp"
+
+namespace myo {
+
+inline
+void decodeEvent(libmyo_event_t event, Myo* myo, DeviceEvent& out)
+{
+    decodeEventHeader(event, myo, out);
+    decodeEventPayload(event, out);
+}
+
+inline
+void decodeEventHeader(libmyo_event_t event, Myo* myo, DeviceEvent& out)
+{
+    out.type = static_cast<libmyo_event_type_t>(libmyo_event_get_type(event));
+    out.timestamp = libmyo_event_get_timestamp(event);
+    out.myo = myo;
+}
+
+inline
+void decodeEventPayload(libmyo_event_t event, DeviceEvent& out)
+{
+    switch (out.type) {
+    case libmyo_event_paired:
+    case libmyo_event_connected:
+        out.firmwareVersion.firmwareVersionMajor = libmyo_event_get_firmware_version(event, libmyo_version_major);
+        out.firmwareVersion.firmwareVersionMinor = libmyo_event_get_firmware_version(event, libmyo_version_minor);
+        out.firmwareVersion.firmwareVersionPatch = libmyo_event_get_firmware_version(event, libmyo_version_patch);
+        out.firmwareVersion.firmwareVersionHardwareRev = libmyo_event_get_firmware_version(event,
+                                                                                           libmyo_version_hardware_rev);
+        break;
+    case libmyo_event_arm_synced:
+        out.armSync.arm = static_cast<Arm>(libmyo_event_get_arm(event));
+        out.armSync.xDirection = static_cast<XDirection>(libmyo_event_get_x_direction(event));
+        out.armSync.rotation = libmyo_event_get_rotation_on_arm(event);
+        out.armSync.warmupState = static_cast<WarmupState>(libmyo_event_get_warmup_state(event));
+        break;
+    case libmyo_event_orientation:
+        out.imu.orientation[0] = libmyo_event_get_orientation(event, libmyo_orientation_x);
+        out.imu.orientation[1] = libmyo_event_get_orientation(event, libmyo_orientation_y);
+        out.imu.orientation[2] = libmyo_event_get_orientation(event, libmyo_orientation_z);
+        out.imu.orientation[3] = libmyo_event_get_orientation(event, libmyo_orientation_w);
+        for (unsigned int i = 0; i < 3; ++i) {
+            out.imu.accelerometer[i] = libmyo_event_get_accelerometer(event, i);
+            out.imu.gyroscope[i] = libmyo_event_get_gyroscope(event, i);
+        }
+        break;
+    case libmyo_event_pose:
+        out.pose = static_cast<Pose::Type>(libmyo_event_get_pose(event));
+        break;
+    case libmyo_event_rssi:
+        out.rssi = libmyo_event_get_rssi(event);
+        break;
+    case libmyo_event_battery_level:
+        out.batteryLevel = libmyo_event_get_battery_level(event);
+        break;
+    case libmyo_event_emg:
+        for (unsigned int i = 0; i < 8; ++i) {
+            out.emg[i] = libmyo_event_get_emg(event, i);
+        }
+        break;
+    case libmyo_event_warmup_completed:
+        out.warmupResult = static_cast<WarmupResult>(libmyo_event_get_warmup_result(event));
+        break;
+    case libmyo_event_unpaired:
+    case libmyo_event_disconnected:
+    case libmyo_event_arm_unsynced:
+    case libmyo_event_unlocked:
+    case libmyo_event_locked:
+        // No payload.
+        break;
+    }
+}
+
+inline
+void dispatchEvent(DeviceListener* listener, const DeviceEvent& event)
+{
+    Myo* myo = event.myo;
+    uint64_t time = event.timestamp;
+
+    switch (event.type) {
+    case libmyo_event_paired:
+        listener->onPair(myo, time, event.firmwareVersion);
+        break;
+    case libmyo_event_unpaired:
+        listener->onUnpair(myo, time);
+        break;
+    case libmyo_event_connected:
+        listener->onConnect(myo, time, event.firmwareVersion);
+        break;
+    case libmyo_event_disconnected:
+        listener->onDisconnect(myo, time);
+        break;
+    case libmyo_event_arm_synced:
+        listener->onArmSync(myo, time, event.armSync.arm, event.armSync.xDirection, event.armSync.rotation,
+                            event.armSync.warmupState);
+        break;
+    case libmyo_event_arm_unsynced:
+        listener->onArmUnsync(myo, time);
+        break;
+    case libmyo_event_unlocked:
+        listener->onUnlock(myo, time);
+        break;
+    case libmyo_event_locked:
+        listener->onLock(myo, time);
+        break;
+    case libmyo_event_orientation: {
+        const DeviceEvent::Imu& imu = event.imu;
+        listener->onOrientationData(myo, time,
+                                    Quaternion<float>(imu.orientation[0], imu.orientation[1],
+                                                      imu.orientation[2], imu.orientation[3]));
+        listener->onAccelerometerData(myo, time,
+                                      Vector3<float>(imu.accelerometer[0], imu.accelerometer[1],
+                                                     imu.accelerometer[2]));
+        listener->onGyroscopeData(myo, time, Vector3<float>(imu.gyroscope[0], imu.gyroscope[1], imu.gyroscope[2]));
+        break;
+    }
+    case libmyo_event_pose:
+        listener->onPose(myo, time, Pose(event.pose));
+        break;
+    case libmyo_event_rssi:
+        listener->onRssi(myo, time, event.rssi);
+        break;
+    case libmyo_event_battery_level:
+        listener->onBatteryLevelReceived(myo, time, event.batteryLevel);
+        break;
+    case libmyo_event_emg:
+        listener->onEmgData(myo, time, event.emg);
+        break;
+    case libmyo_event_warmup_completed:
+        listener->onWarmupCompleted(myo, time, event.warmupResult);
+        break;
+    }
+}
+
+} // namespace myo
@@ -0,0 +1,186 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#include "../EmgFeatures.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "../detail/SimdPack.hpp"
+
+namespace myo {
+
+inline
+EmgFeatureExtractor::EmgFeatureExtractor(std::size_t window, std::size_t hop, int zeroCrossingThreshold)
+: _window(window)
+, _hop(hop)
+, _zeroCrossingThreshold(zeroCrossingThreshold)
+, _tracks()
+{
+    // The sums are 32-bit: a window of 65536 samples keeps the sum of squares below 2^31.
+    if (window < 2 || window > 65536) {
+        throw std::invalid_argument("The EMG window must hold between 2 and 65536 samples");
+    }
+    if (hop == 0) {
+        throw std::invalid_argument("The EMG hop size must be at least one sample");
+    }
+}
+
+inline
+void EmgFeatureExtractor::reset()
+{
+    _tracks.clear();
+}
+
+inline
+EmgFeatureExtractor::Track& EmgFeatureExtractor::track(Myo* myo)
+{
+    Track* track = _tracks.find(myo);
+    if (!track) {
+        // The sums and counts start out at zero.
+        track = &_tracks.get(myo);
+        track->untilHop = 1;
+        track->ring.resize(_window * 8);
+    }
+    return *track;
+}
+
+inline
+void EmgFeatureExtractor::onEmgData(Myo* myo, uint64_t timestamp, const int8_t* emg)
+{
+    addSample(myo, track(myo), timestamp, emg);
+}
+
+inline
+void EmgFeatureExtractor::onEmgBatch(Myo* myo, const EmgBatch& batch)
+{
+    Track& t = track(myo);
+
+    int8_t emg[8];
+    for (std::size_t i = 0; i < batch.size; ++i) {
+        for (unsigned int sensor = 0; sensor < 8; ++sensor) {
+            emg[sensor] = batch.channels[sensor][i];
+        }
+        addSample(myo, t, batch.timestamps[i], emg);
+    }
+}
+
+inline
+void EmgFeatureExtractor::addSample(Myo* myo, Track& track, uint64_t timestamp, const int8_t* emg)
+{
+    static const int8_t zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+    int8_t* slot = &track.ring[track.position * 8];
+
+    // Once the window is full, the oldest sample, about to be overwritten, leaves it along with the step to the sample
+    // after it. Standing in zeros for samples that are not there yet, and the new sample for its own predecessor,
+    // lets every sample take the same branch-free path.
+    const bool full = track.count >= _window;
+    const int8_t* oldest = full ? slot : zeros;
+    const int8_t* next = full ? &track.ring[(track.position + 1 == _window ? 0 : track.position + 1) * 8] : zeros;
+    const int8_t* previous = track.count ? &track.ring[(track.position ? track.position : _window) * 8 - 8] : emg;
+
+#if defined(MYO_SIMD_X86)
+    // All 8 sensors fit in one register of 16-bit lanes: readings are at most 128 in magnitude, so their squares
+    // and the differences between them fit, and the changes to the sums are widened to 32 bits only at the end.
+    const __m128i threshold = _mm_set1_epi16(static_cast<short>(_zeroCrossingThreshold - 1));
+    struct local {
+        static __m128i load(const int8_t* p)
+        {
+            __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+            return _mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8);
+        }
+        static __m128i abs(__m128i v) { return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v)); }
+        static __m128i crossing(__m128i from, __m128i to, __m128i distance, __m128i threshold)
+        {
+            __m128i zero = _mm_setzero_si128();
+            __m128i up = _mm_and_si128(_mm_cmplt_epi16(from, zero), _mm_cmpgt_epi16(to, zero));
+            __m128i down = _mm_and_si128(_mm_cmpgt_epi16(from, zero), _mm_cmplt_epi16(to, zero));
+            return _mm_and_si128(_mm_or_si128(up, down), _mm_cmpgt_epi16(distance, threshold));
+        }
+        static void accumulate(int32_t* sums, __m128i delta)
+        {
+            __m128i* out = reinterpret_cast<__m128i*>(sums);
+            __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(delta, delta), 16);
+            __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(delta, delta), 16);
+            _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), low));
+            _mm_storeu_si128(out + 1, _mm_add_epi32(_mm_loadu_si128(out + 1), high));
+        }
+    };
+
+    __m128i value = local::load(emg);
+    __m128i before = local::load(previous);
+    __m128i leaving = local::load(oldest);
+    __m128i after = local::load(next);
+
+    __m128i step = local::abs(_mm_sub_epi16(value, before));
+    __m128i leavingStep = local::abs(_mm_sub_epi16(after, leaving));
+
+    local::accumulate(track.sumSquares, _mm_sub_epi16(_mm_mullo_epi16(value, value),
+                                                      _mm_mullo_epi16(leaving, leaving)));
+    local::accumulate(track.sumAbs, _mm_sub_epi16(local::abs(value), local::abs(leaving)));
+    local::accumulate(track.length, _mm_sub_epi16(step, leavingStep));
+    // Crossing masks are -1 where set, so the leaving mask is added and the new one subtracted.
+    local::accumulate(track.crossings, _mm_sub_epi16(local::crossing(leaving, after, leavingStep, threshold),
+                                                     local::crossing(before, value, step, threshold)));
+#else
+    const int32_t threshold = _zeroCrossingThreshold;
+    for (unsigned int i = 0; i < 8; ++i) {
+        int32_t value = emg[i], before = previous[i], leaving = oldest[i], after = next[i];
+        int32_t step = std::abs(value - before);
+        int32_t leavingStep = std::abs(after - leaving);
+        track.sumSquares[i] += value * value - leaving * leaving;
+        track.sumAbs[i] += std::abs(value) - std::abs(leaving);
+        track.length[i] += step - leavingStep;
+        int32_t crossing = ((before < 0 && value > 0) || (before > 0 && value < 0)) && step >= threshold;
+        int32_t leavingCrossing = ((leaving < 0 && after > 0) || (leaving > 0 && after < 0))
+                                  && leavingStep >= threshold;
+        track.crossings[i] += crossing - leavingCrossing;
+    }
+#endif
+
+    for (unsigned int i = 0; i < 8; ++i) {
+        slot[i] = emg[i];
+    }
+
+    track.position = track.position + 1 == _window ? 0 : track.position + 1;
+    ++track.count;
+    track.lastTimestamp = timestamp;
+
+    if (track.count >= _window && --track.untilHop == 0) {
+        track.untilHop = _hop;
+        emit(myo, track);
+    }
+}
+
+inline
+void EmgFeatureExtractor::emit(Myo* myo, const Track& track)
+{
+    EmgFeatures features;
+    features.timestamp = track.lastTimestamp;
+    features.window = _window;
+
+    const float scale = 1.0f / _window;
+    for (unsigned int i = 0; i < 8; ++i) {
+        features.rms[i] = std::sqrt(track.sumSquares[i] * scale);
+        features.mav[i] = track.sumAbs[i] * scale;
+        features.zeroCrossings[i] = static_cast<float>(track.crossings[i]);
+        features.waveformLength[i] = static_cast<float>(track.length[i]);
+    }
+
+    onEmgFeatures(myo, features);
+}
+
+inline
+void EmgFeatureExtractor::onDisconnect(Myo* myo, uint64_t timestamp)
+{
+    _tracks.erase(myo);
+}
+
+inline
+void EmgFeatureExtractor::onUnpair(Myo* myo, uint64_t timestamp)
+{
+    onDisconnect(myo, timestamp);
+}
+
+} // namespace myo
@@ -0,0 +1,66 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+
+#include "../EulerAngles.hpp"
+
+#include <stdexcept>
+
+namespace myo {
+
+inline
+EulerAngles toEuler(const Quaternion<float>& quat)
+{
+    float x = quat.x(), y = quat.y(), z = quat.z(), w = quat.w();
+    const float* q[4] = {&x, &y, &z, &w};
+
+    EulerAngles angles;
+    float* result[3] = {&angles.roll, &angles.pitch, &angles.yaw};
+    simd::scalar::eulerAngles(q, result, 0, 1);
+    return angles;
+}
+
+inline
+void toEuler(const QuaternionArray& quats, float* roll, float* pitch, float* yaw)
+{
+    const float* q[4] = {quats.x(), quats.y(), quats.z(), quats.w()};
+    float* result[3] = {roll, pitch, yaw};
+
+    const simd::QuaternionKernels& kernels = simd::quaternionKernels(simdLevel());
+    std::size_t body = simd::bodySize(kernels, quats.size());
+    kernels.eulerAngles(q, result, 0, body);
+    simd::scalar::eulerAngles(q, result, body, quats.size());
+}
+
+inline
+EulerBuckets toEulerBuckets(const Quaternion<float>& quat, int buckets)
+{
+    if (buckets < 1) {
+        throw std::invalid_argument("Number of buckets must be positive");
+    }
+
+    float x = quat.x(), y = quat.y(), z = quat.z(), w = quat.w();
+    const float* q[4] = {&x, &y, &z, &w};
+
+    EulerBuckets steps;
+    int* result[3] = {&steps.roll, &steps.pitch, &steps.yaw};
+    simd::scalar::eulerBuckets(q, result, static_cast<float>(buckets), 0, 1);
+    return steps;
+}
+
+inline
+void toEulerBuckets(const QuaternionArray& quats, int buckets, int* roll, int* pitch, int* yaw)
+{
+    if (buckets < 1) {
+        throw std::invalid_argument("Number of buckets must be positive");
+    }
+
+    const float* q[4] = {quats.x(), quats.y(), quats.z(), quats.w()};
+    int* result[3] = {roll, pitch, yaw};
+
+    const simd::QuaternionKernels& kernels = simd::quaternionKernels(simdLevel());
+    std::size_t body = simd::bodySize(kernels, quats.size());
+    kernels.eulerBuckets(q, result, static_cast<float>(buckets), 0, body);
+    simd::scalar::eulerBuckets(q, result, static_cast<float>(buckets), body, quats.size());
+}
+
+} // namespace myo
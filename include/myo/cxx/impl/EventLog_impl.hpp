@@ -0,0 +1,337 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#include "../EventLog.hpp"
+
+namespace myo {
+
+namespace eventlog {
+
+static const unsigned char signature[8] = { 'M', 'Y', 'O', 'L', 'O', 'G', 0, 1 };
+
+enum {
+    deviceTag = 0xff,
+    devicePaired = 0x01,
+    flushThreshold = 64 * 1024
+};
+
+} // namespace eventlog
+
+inline
+EventLogWriter::EventLogWriter(const std::string& path)
+: _file(std::fopen(path.c_str(), "wb"))
+, _buffer()
+, _devices(0)
+, _lastTimestamp(0)
+{
+    if (!_file) {
+        throw std::runtime_error("Unable to open event log for writing: " + path);
+    }
+    _buffer.reserve(eventlog::flushThreshold + 64);
+    _buffer.insert(_buffer.end(), eventlog::signature, eventlog::signature + sizeof(eventlog::signature));
+}
+
+inline
+EventLogWriter::~EventLogWriter()
+{
+    flush();
+    std::fclose(_file);
+}
+
+inline
+uint32_t EventLogWriter::addDevice(uint64_t macAddress, bool paired)
+{
+    putByte(eventlog::deviceTag);
+    putByte(paired ? eventlog::devicePaired : 0);
+    putU64(macAddress);
+    return _devices++;
+}
+
+inline
+void EventLogWriter::write(uint32_t device, const DeviceEvent& event)
+{
+    putByte(static_cast<unsigned char>(event.type));
+    putVarint(device);
+
+    // Zigzag-encode the delta so that an out-of-order timestamp does not blow up to ten bytes.
+    int64_t delta = static_cast<int64_t>(event.timestamp - _lastTimestamp);
+    putVarint((static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+    _lastTimestamp = event.timestamp;
+
+    switch (event.type) {
+    case libmyo_event_paired:
+    case libmyo_event_connected:
+        putU32(event.firmwareVersion.firmwareVersionMajor);
+        putU32(event.firmwareVersion.firmwareVersionMinor);
+        putU32(event.firmwareVersion.firmwareVersionPatch);
+        putU32(event.firmwareVersion.firmwareVersionHardwareRev);
+        break;
+    case libmyo_event_arm_synced:
+        putByte(static_cast<unsigned char>(event.armSync.arm));
+        putByte(static_cast<unsigned char>(event.armSync.xDirection));
+        putByte(static_cast<unsigned char>(event.armSync.warmupState));
+        putFloat(event.armSync.rotation);
+        break;
+    case libmyo_event_orientation:
+        for (int i = 0; i < 4; ++i) {
+            putFloat(event.imu.orientation[i]);
+        }
+        for (int i = 0; i < 3; ++i) {
+            putFloat(event.imu.accelerometer[i]);
+        }
+        for (int i = 0; i < 3; ++i) {
+            putFloat(event.imu.gyroscope[i]);
+        }
+        break;
+    case libmyo_event_pose:
+        putVarint(static_cast<uint64_t>(event.pose));
+        break;
+    case libmyo_event_rssi:
+        putByte(static_cast<unsigned char>(event.rssi));
+        break;
+    case libmyo_event_battery_level:
+        putByte(event.batteryLevel);
+        break;
+    case libmyo_event_emg:
+        for (int i = 0; i < 8; ++i) {
+            putByte(static_cast<unsigned char>(event.emg[i]));
+        }
+        break;
+    case libmyo_event_warmup_completed:
+        putByte(static_cast<unsigned char>(event.warmupResult));
+        break;
+    case libmyo_event_unpaired:
+    case libmyo_event_disconnected:
+    case libmyo_event_arm_unsynced:
+    case libmyo_event_unlocked:
+    case libmyo_event_locked:
+        break;
+    }
+
+    if (_buffer.size() >= eventlog::flushThreshold) {
+        flush();
+    }
+}
+
+inline
+void EventLogWriter::flush()
+{
+    if (!_buffer.empty()) {
+        std::fwrite(&_buffer[0], 1, _buffer.size(), _file);
+        _buffer.clear();
+    }
+    std::fflush(_file);
+}
+
+inline
+void EventLogWriter::putVarint(uint64_t value)
+{
+    while (value >= 0x80) {
+        putByte(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    putByte(static_cast<unsigned char>(value));
+}
+
+inline
+void EventLogWriter::putU32(uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        putByte(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+inline
+void EventLogWriter::putU64(uint64_t value)
+{
+    for (int i = 0; i < 8; ++i) {
+        putByte(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+inline
+void EventLogWriter::putFloat(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU32(bits);
+}
+
+inline
+EventLogReader::EventLogReader(const std::string& path)
+: _file(std::fopen(path.c_str(), "rb"))
+, _devices()
+, _pendingPairs()
+, _lastTimestamp(0)
+{
+    if (!_file) {
+        throw std::runtime_error("Unable to open event log for reading: " + path);
+    }
+
+    unsigned char header[sizeof(eventlog::signature)];
+    if (std::fread(header, 1, sizeof(header), _file) != sizeof(header)
+        || std::memcmp(header, eventlog::signature, sizeof(header)) != 0) {
+        std::fclose(_file);
+        throw std::runtime_error("Not an event log: " + path);
+    }
+}
+
+inline
+EventLogReader::~EventLogReader()
+{
+    std::fclose(_file);
+}
+
+inline
+bool EventLogReader::next(EventRecord& out)
+{
+    for (;;) {
+        if (!_pendingPairs.empty()) {
+            // Stand in for the pairing the recorder never saw, timestamped just before the device's first event.
+            out.device = _pendingPairs.back();
+            out.macAddress = _devices[out.device];
+            out.event.type = libmyo_event_paired;
+            out.event.timestamp = _lastTimestamp;
+            out.event.myo = 0;
+            std::memset(&out.event.firmwareVersion, 0, sizeof(out.event.firmwareVersion));
+            _pendingPairs.pop_back();
+            return true;
+        }
+
+        int tag = std::getc(_file);
+        if (tag == EOF) {
+            return false;
+        }
+
+        if (tag == eventlog::deviceTag) {
+            unsigned char flags = readByte();
+            _devices.push_back(readU64());
+            if (!(flags & eventlog::devicePaired)) {
+                _pendingPairs.push_back(static_cast<uint32_t>(_devices.size() - 1));
+            }
+            continue;
+        }
+
+        out.device = static_cast<uint32_t>(readVarint());
+        if (out.device >= _devices.size()) {
+            throw std::runtime_error("Malformed event log: undeclared device");
+        }
+        out.macAddress = _devices[out.device];
+
+        uint64_t zigzag = readVarint();
+        _lastTimestamp += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+
+        DeviceEvent& event = out.event;
+        event.type = static_cast<libmyo_event_type_t>(tag);
+        event.timestamp = _lastTimestamp;
+        event.myo = 0;
+
+        switch (event.type) {
+        case libmyo_event_paired:
+        case libmyo_event_connected:
+            event.firmwareVersion.firmwareVersionMajor = readU32();
+            event.firmwareVersion.firmwareVersionMinor = readU32();
+            event.firmwareVersion.firmwareVersionPatch = readU32();
+            event.firmwareVersion.firmwareVersionHardwareRev = readU32();
+            break;
+        case libmyo_event_arm_synced:
+            event.armSync.arm = static_cast<Arm>(readByte());
+            event.armSync.xDirection = static_cast<XDirection>(readByte());
+            event.armSync.warmupState = static_cast<WarmupState>(readByte());
+            event.armSync.rotation = readFloat();
+            break;
+        case libmyo_event_orientation:
+            for (int i = 0; i < 4; ++i) {
+                event.imu.orientation[i] = readFloat();
+            }
+            for (int i = 0; i < 3; ++i) {
+                event.imu.accelerometer[i] = readFloat();
+            }
+            for (int i = 0; i < 3; ++i) {
+                event.imu.gyroscope[i] = readFloat();
+            }
+            break;
+        case libmyo_event_pose:
+            event.pose = static_cast<Pose::Type>(readVarint());
+            break;
+        case libmyo_event_rssi:
+            event.rssi = static_cast<int8_t>(readByte());
+            break;
+        case libmyo_event_battery_level:
+            event.batteryLevel = readByte();
+            break;
+        case libmyo_event_emg:
+            for (int i = 0; i < 8; ++i) {
+                event.emg[i] = static_cast<int8_t>(readByte());
+            }
+            break;
+        case libmyo_event_warmup_completed:
+            event.warmupResult = static_cast<WarmupResult>(readByte());
+            break;
+        case libmyo_event_unpaired:
+        case libmyo_event_disconnected:
+        case libmyo_event_arm_unsynced:
+        case libmyo_event_unlocked:
+        case libmyo_event_locked:
+            break;
+        default:
+            throw std::runtime_error("Malformed event log: unknown event type");
+        }
+
+        return true;
+    }
+}
+
+inline
+unsigned char EventLogReader::readByte()
+{
+    int byte = std::getc(_file);
+    if (byte == EOF) {
+        throw std::runtime_error("Malformed event log: unexpected end of file");
+    }
+    return static_cast<unsigned char>(byte);
+}
+
+inline
+uint64_t EventLogReader::readVarint()
+{
+    uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+        unsigned char byte = readByte();
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw std::runtime_error("Malformed event log: varint too long");
+}
+
+inline
+uint32_t EventLogReader::readU32()
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(readByte()) << (8 * i);
+    }
+    return value;
+}
+
+inline
+uint64_t EventLogReader::readU64()
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(readByte()) << (8 * i);
+    }
+    return value;
+}
+
+inline
+float EventLogReader::readFloat()
+{
+    uint32_t bits = readU32();
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace myo
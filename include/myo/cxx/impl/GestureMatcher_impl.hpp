@@ -0,0 +1,250 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#include "../GestureMatcher.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace myo {
+
+inline
+GestureMatcher::GestureMatcher(float threshold, float band)
+: _threshold(threshold)
+, _band(band)
+, _templates()
+, _maxLength(0)
+, _history()
+, _historyEnd(0)
+, _historySize(0)
+, _candidate()
+, _rows()
+{
+}
+
+inline
+std::size_t GestureMatcher::addTemplate(const std::vector<EulerAngles>& samples)
+{
+    if (samples.size() < 2) {
+        throw std::invalid_argument("A gesture template needs at least two samples");
+    }
+
+    Template pattern;
+    pattern.length = samples.size();
+    pattern.band = static_cast<std::size_t>(_band * pattern.length + 0.5f);
+    pattern.values.resize(pattern.length * 3);
+    for (std::size_t i = 0; i < pattern.length; ++i) {
+        relativeAngles(samples[i], samples[0], &pattern.values[i * 3]);
+    }
+
+    pattern.upper.resize(pattern.length * 3);
+    pattern.lower.resize(pattern.length * 3);
+    for (std::size_t i = 0; i < pattern.length; ++i) {
+        std::size_t first = i > pattern.band ? i - pattern.band : 0;
+        std::size_t last = std::min(pattern.length - 1, i + pattern.band);
+        for (std::size_t k = 0; k < 3; ++k) {
+            float upper = pattern.values[first * 3 + k];
+            float lower = upper;
+            for (std::size_t j = first + 1; j <= last; ++j) {
+                upper = std::max(upper, pattern.values[j * 3 + k]);
+                lower = std::min(lower, pattern.values[j * 3 + k]);
+            }
+            pattern.upper[i * 3 + k] = upper;
+            pattern.lower[i * 3 + k] = lower;
+        }
+    }
+
+    _templates.push_back(pattern);
+
+    // The stream is kept in a ring as long as the longest template.
+    if (pattern.length > _maxLength) {
+        _maxLength = pattern.length;
+        _history.resize(_maxLength);
+        _candidate.resize(_maxLength * 3);
+        _rows.resize(_maxLength * 2);
+        reset();
+    }
+
+    return _templates.size() - 1;
+}
+
+inline
+void GestureMatcher::clearTemplates()
+{
+    _templates.clear();
+    _maxLength = 0;
+    _history.clear();
+    _candidate.clear();
+    _rows.clear();
+    reset();
+}
+
+inline
+void GestureMatcher::reset()
+{
+    _historyEnd = 0;
+    _historySize = 0;
+}
+
+inline
+bool GestureMatcher::update(const EulerAngles& angles, Match& match)
+{
+    if (_templates.empty()) {
+        return false;
+    }
+
+    _history[_historyEnd] = angles;
+    _historyEnd = (_historyEnd + 1) % _maxLength;
+    if (_historySize < _maxLength) {
+        ++_historySize;
+    }
+
+    // Distances are compared per sample, since templates differ in length.
+    float best = _threshold;
+    std::size_t bestIndex = _templates.size();
+
+    // The lower bound reads the stream straight from the history, so a rejected template costs no more than the
+    // samples it takes to reject it. The candidate is only built for templates that get past it, once per length.
+    std::size_t candidateLength = 0;
+
+    for (std::size_t t = 0; t < _templates.size(); ++t) {
+        const Template& pattern = _templates[t];
+        std::size_t length = pattern.length;
+        if (length > _historySize) {
+            continue;
+        }
+
+        std::size_t start = (_historyEnd + _maxLength - length) % _maxLength;
+        float bound = best * length;
+        if (lowerBound(pattern, start, bound) >= bound) {
+            continue;
+        }
+        if (length != candidateLength) {
+            buildCandidate(start, length);
+            candidateLength = length;
+        }
+        float distance = warpingDistance(pattern, bound);
+        if (distance < bound) {
+            best = distance / length;
+            bestIndex = t;
+        }
+    }
+
+    if (bestIndex == _templates.size()) {
+        return false;
+    }
+
+    match.templateIndex = bestIndex;
+    match.distance = best;
+    reset();
+    return true;
+}
+
+inline
+float GestureMatcher::wrapAngle(float angle)
+{
+    const float pi = 3.14159265f;
+    if (angle > pi) {
+        return angle - 2 * pi;
+    } else if (angle < -pi) {
+        return angle + 2 * pi;
+    }
+    return angle;
+}
+
+// Store the roll, pitch and yaw of \a sample relative to \a first in \a values, with roll and yaw wrapped into
+// [-pi, pi].
+inline
+void GestureMatcher::relativeAngles(const EulerAngles& sample, const EulerAngles& first, float* values)
+{
+    values[0] = wrapAngle(sample.roll - first.roll);
+    values[1] = sample.pitch - first.pitch;
+    values[2] = wrapAngle(sample.yaw - first.yaw);
+}
+
+// Return the LB_Keogh lower bound of the warping distance between the stream starting at history position \a start
+// and \a pattern: the squared distance from each stream value to the template's envelope around the same position.
+// Summing stops once \a bound is reached.
+inline
+float GestureMatcher::lowerBound(const Template& pattern, std::size_t start, float bound) const
+{
+    const EulerAngles& first = _history[start];
+    float sum = 0;
+    for (std::size_t i = 0; i < pattern.length && sum < bound; ++i) {
+        float values[3];
+        relativeAngles(_history[(start + i) % _maxLength], first, values);
+        for (std::size_t k = 0; k < 3; ++k) {
+            float value = values[k];
+            float upper = pattern.upper[i * 3 + k];
+            float lower = pattern.lower[i * 3 + k];
+            if (value > upper) {
+                sum += (value - upper) * (value - upper);
+            } else if (value < lower) {
+                sum += (lower - value) * (lower - value);
+            }
+        }
+    }
+    return sum;
+}
+
+// Fill the candidate with the \a length samples of the stream starting at history position \a start.
+inline
+void GestureMatcher::buildCandidate(std::size_t start, std::size_t length)
+{
+    const EulerAngles& first = _history[start];
+    for (std::size_t i = 0; i < length; ++i) {
+        relativeAngles(_history[(start + i) % _maxLength], first, &_candidate[i * 3]);
+    }
+}
+
+// Return the warping distance between the candidate and \a pattern, or infinity if it is at least \a bound.
+// Only two rows of the cost matrix are kept; a row whose every cell is already at least \a bound ends the search.
+inline
+float GestureMatcher::warpingDistance(const Template& pattern, float bound)
+{
+    const float infinity = std::numeric_limits<float>::infinity();
+    std::size_t length = pattern.length;
+    std::size_t band = pattern.band;
+
+    float* previous = &_rows[0];
+    float* current = &_rows[length];
+    std::fill(previous, previous + length * 2, infinity);
+
+    for (std::size_t i = 0; i < length; ++i) {
+        std::size_t first = i > band ? i - band : 0;
+        std::size_t last = std::min(length - 1, i + band);
+        if (first > 0) {
+            current[first - 1] = infinity;
+        }
+
+        const float* c = &_candidate[i * 3];
+        float rowMinimum = infinity;
+        for (std::size_t j = first; j <= last; ++j) {
+            const float* p = &pattern.values[j * 3];
+            float cost = (c[0] - p[0]) * (c[0] - p[0]) + (c[1] - p[1]) * (c[1] - p[1])
+                       + (c[2] - p[2]) * (c[2] - p[2]);
+
+            float step;
+            if (i == 0) {
+                step = j == 0 ? 0 : current[j - 1];
+            } else {
+                step = previous[j];
+                if (j > 0) {
+                    step = std::min(step, std::min(previous[j - 1], current[j - 1]));
+                }
+            }
+
+            current[j] = cost + step;
+            rowMinimum = std::min(rowMinimum, current[j]);
+        }
+
+        if (rowMinimum >= bound) {
+            return infinity;
+        }
+        std::swap(previous, current);
+    }
+
+    return previous[length - 1];
+}
+
+} // namespace myo
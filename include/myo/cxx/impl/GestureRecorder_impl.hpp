@@ -0,0 +1,139 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#include "../GestureRecorder.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace myo {
+
+inline
+GestureRecorder::GestureRecorder(std::size_t movementsPerGesture, float startAngle, float stopSpeed,
+                                 uint64_t settleTime, uint64_t restTimeout)
+: _movementsPerGesture(movementsPerGesture)
+, _startAngle(startAngle)
+, _stopSpeed(stopSpeed)
+, _settleTime(settleTime)
+, _restTimeout(restTimeout)
+, _tracks()
+{
+    if (movementsPerGesture == 0) {
+        throw std::invalid_argument("A gesture must consist of at least one movement");
+    }
+}
+
+inline
+void GestureRecorder::reset()
+{
+    _tracks.clear();
+}
+
+inline
+bool GestureRecorder::isMoving(Myo* myo) const
+{
+    const Track* track = _tracks.find(myo);
+    return track && track->state == stateMoving;
+}
+
+inline
+void GestureRecorder::onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation)
+{
+    Track& track = _tracks.get(myo);
+    EulerAngles angles = toEuler(rotation);
+
+    switch (track.state) {
+    case stateIdle:
+        track.rest = angles;
+        track.state = stateResting;
+        break;
+    case stateResting:
+        if (largestAngle(angleChange(track.rest, angles)) > _startAngle) {
+            track.movement.startTimestamp = timestamp;
+            track.stillSince = timestamp;
+            track.state = stateMoving;
+        }
+        if (track.state == stateResting && !track.gesture.movements.empty()
+            && timestamp - track.movement.endTimestamp > _restTimeout) {
+            // The rest of the gesture never came.
+            track.gesture.movements.clear();
+            track.gesture.samples.clear();
+        }
+        if (track.state == stateMoving || !track.gesture.movements.empty()) {
+            track.gesture.samples.push_back(angles);
+        }
+        break;
+    case stateMoving: {
+        track.gesture.samples.push_back(angles);
+        uint64_t elapsed = timestamp > track.lastTimestamp ? timestamp - track.lastTimestamp : 0;
+        float speed = largestAngle(angleChange(track.last, angles)) * 1e6f / (elapsed ? elapsed : 1);
+        if (speed >= _stopSpeed) {
+            track.stillSince = timestamp;
+        } else if (timestamp - track.stillSince >= _settleTime) {
+            track.movement.endTimestamp = timestamp;
+            track.movement.change = angleChange(track.rest, angles);
+            track.rest = angles;
+            track.state = stateResting;
+            track.gesture.movements.push_back(track.movement);
+
+            onMovement(myo, timestamp, track.movement);
+            if (track.gesture.movements.size() == _movementsPerGesture) {
+                onGesture(myo, timestamp, track.gesture);
+                track.gesture.movements.clear();
+                track.gesture.samples.clear();
+            }
+        }
+        break;
+    }
+    }
+
+    track.last = angles;
+    track.lastTimestamp = timestamp;
+}
+
+// Return to - from, with roll and yaw wrapped into [-pi, pi] so that changes across the +-pi seam stay small.
+inline
+EulerAngles GestureRecorder::angleChange(const EulerAngles& from, const EulerAngles& to)
+{
+    const float pi = 3.14159265f;
+    EulerAngles change;
+    change.roll = to.roll - from.roll;
+    change.pitch = to.pitch - from.pitch;
+    change.yaw = to.yaw - from.yaw;
+
+    float* wrapped[2] = {&change.roll, &change.yaw};
+    for (int i = 0; i < 2; ++i) {
+        if (*wrapped[i] > pi) {
+            *wrapped[i] -= 2 * pi;
+        } else if (*wrapped[i] < -pi) {
+            *wrapped[i] += 2 * pi;
+        }
+    }
+    return change;
+}
+
+inline
+float GestureRecorder::largestAngle(const EulerAngles& angles)
+{
+    float largest = std::fabs(angles.roll);
+    if (std::fabs(angles.pitch) > largest) {
+        largest = std::fabs(angles.pitch);
+    }
+    if (std::fabs(angles.yaw) > largest) {
+        largest = std::fabs(angles.yaw);
+    }
+    return largest;
+}
+
+inline
+void GestureRecorder::onDisconnect(Myo* myo, uint64_t timestamp)
+{
+    _tracks.erase(myo);
+}
+
+inline
+void GestureRecorder::onUnpair(Myo* myo, uint64_t timestamp)
+{
+    onDisconnect(myo, timestamp);
+}
+
+} // namespace myo
@@ -4,8 +4,11 @@
 
 #include <algorithm>
 #include <exception>
+#include <new>
 
+#include "../DeviceEvent.hpp"
 #include "../DeviceListener.hpp"
+#include "../DispatchObserver.hpp"
 #include "../Myo.hpp"
 #include "../Pose.hpp"
 #include "../Quaternion.hpp"
@@ -18,22 +21,78 @@ inline
 Hub::Hub(const std::string& applicationIdentifier)
 : _hub(0)
 , _myos()
+, _myoTable()
+, _myoPool()
 , _listeners()
+, _listenerEvents()
+, _eventSink(0)
+, _observer(0)
+, _batchSize(0)
+, _batchers()
+, _commandRate(0)
+, _commandBurst(0)
+, _health()
+, _healthSink(0)
+, _restoreOnConnect(true)
+, _clock(0)
+, _lastTimestamp(0)
+, _idleCredit(0)
+, _shardIndex(0)
+, _shardCount(1)
 {
     libmyo_init_hub(&_hub, applicationIdentifier.c_str(), ThrowOnError());
 }
 
+inline
+Hub::Hub(const std::string& applicationIdentifier, ErrorCode& error)
+: _hub(0)
+, _myos()
+, _myoTable()
+, _myoPool()
+, _listeners()
+, _listenerEvents()
+, _eventSink(0)
+, _observer(0)
+, _batchSize(0)
+, _batchers()
+, _commandRate(0)
+, _commandBurst(0)
+, _health()
+, _healthSink(0)
+, _restoreOnConnect(true)
+, _clock(0)
+, _lastTimestamp(0)
+, _idleCredit(0)
+, _shardIndex(0)
+, _shardCount(1)
+{
+    libmyo_init_hub(&_hub, applicationIdentifier.c_str(), error);
+}
+
 inline
 Hub::~Hub()
 {
     for (std::vector<Myo*>::iterator I = _myos.begin(), IE = _myos.end(); I != IE; ++I) {
-        delete *I;
+        // Myo storage belongs to _myoPool, which releases it once the Hub is gone.
+        (*I)->~Myo();
+    }
+    // A hub whose construction failed never got a libmyo hub to shut down.
+    if (_hub) {
+        libmyo_shutdown_hub(_hub, 0);
     }
-    libmyo_shutdown_hub(_hub, 0);
 }
 
 inline
 Myo* Hub::waitForMyo(unsigned int timeout_ms)
+{
+    ErrorCode error;
+    Myo* myo = waitForMyo(timeout_ms, error);
+    throwIfFailed(error);
+    return myo;
+}
+
+inline
+Myo* Hub::waitForMyo(unsigned int timeout_ms, ErrorCode& error)
 {
     std::size_t prevSize = _myos.size();
 
@@ -45,6 +104,9 @@ Myo* Hub::waitForMyo(unsigned int timeout_ms)
 
             switch (libmyo_event_get_type(event)) {
             case libmyo_event_paired:
+                if (!hub->ownsMyo(opaque_myo)) {
+                    break;
+                }
                 hub->addMyo(opaque_myo);
                 return libmyo_handler_stop;
             default:
@@ -56,8 +118,8 @@ Myo* Hub::waitForMyo(unsigned int timeout_ms)
     };
 
     do {
-        libmyo_run(_hub, timeout_ms ? timeout_ms : 1000, &local::handler, this, ThrowOnError());
-    } while (!timeout_ms && _myos.size() <= prevSize);
+        libmyo_run(_hub, timeout_ms ? timeout_ms : 1000, &local::handler, this, error);
+    } while (!timeout_ms && _myos.size() <= prevSize && !error.failed());
 
     if (_myos.size() <= prevSize) {
         return 0;
@@ -67,13 +129,17 @@ Myo* Hub::waitForMyo(unsigned int timeout_ms)
 }
 
 inline
-void Hub::addListener(DeviceListener* listener)
+void Hub::addListener(DeviceListener* listener, uint32_t events)
 {
-    if (std::find(_listeners.begin(), _listeners.end(), listener) != _listeners.end()) {
-        // Listener was already added.
-        return;
+    std::vector<DeviceListener*>::iterator I = std::find(_listeners.begin(), _listeners.end(), listener);
+    if (I != _listeners.end()) {
+        // Listener was already added, only its subscription changes.
+        _listenerEvents[I - _listeners.begin()] = events;
+    } else {
+        _listeners.push_back(listener);
+        _listenerEvents.push_back(events);
     }
-    _listeners.push_back(listener);
+    updateEventListeners();
 }
 
 inline
@@ -85,7 +151,281 @@ void Hub::removeListener(DeviceListener* listener)
         return;
     }
 
+    _listenerEvents.erase(_listenerEvents.begin() + (I - _listeners.begin()));
     _listeners.erase(I);
+    updateEventListeners();
+}
+
+inline
+void Hub::setEventSink(DeviceEventSink* sink)
+{
+    _eventSink = sink;
+}
+
+inline
+void Hub::dispatch(const DeviceEvent& event)
+{
+    const std::vector<DeviceListener*>& listeners = eventListeners(event.type);
+    for (std::vector<DeviceListener*>::const_iterator I = listeners.begin(), IE = listeners.end(); I != IE; ++I) {
+        if (_observer) {
+            _observer->onListenerBegin(*I, event.type);
+        }
+        dispatchEvent(*I, event);
+        if (_observer) {
+            _observer->onListenerEnd(*I, event.type);
+        }
+    }
+
+    batchEvent(event);
+
+    if (_observer) {
+        _observer->onEventHandled(event.type, event.timestamp);
+    }
+}
+
+inline
+void Hub::setDispatchObserver(DispatchObserver* observer)
+{
+    _observer = observer;
+}
+
+inline
+void Hub::setBatchSize(std::size_t samples)
+{
+    flushBatches();
+    _batchSize = samples;
+}
+
+inline
+void Hub::flushBatches()
+{
+    for (std::vector<SampleBatcher>::iterator I = _batchers.begin(), IE = _batchers.end(); I != IE; ++I) {
+        flushBatch(*I);
+    }
+}
+
+inline
+void Hub::setCommandRate(unsigned int commandsPerSecond, unsigned int burst)
+{
+    _commandRate = commandsPerSecond;
+    _commandBurst = burst ? burst : 1;
+    for (std::vector<Myo*>::iterator I = _myos.begin(), IE = _myos.end(); I != IE; ++I) {
+        (*I)->_commands.setEnabled(_commandRate != 0);
+    }
+}
+
+inline
+void Hub::flushCommands()
+{
+    ErrorCode error;
+    flushCommands(error);
+    throwIfFailed(error);
+}
+
+inline
+void Hub::flushCommands(ErrorCode& error)
+{
+    const uint64_t interval = _commandRate ? 1000000 / _commandRate : 0;
+    for (std::vector<Myo*>::iterator I = _myos.begin(), IE = _myos.end(); I != IE; ++I) {
+        CommandQueue& commands = (*I)->_commands;
+        CommandQueue::Kind kind;
+        int value;
+        while (commands.next(_clock, interval, _commandBurst, kind, value)) {
+            CommandQueue::send((*I)->_myo, kind, value, error);
+            if (error.failed()) {
+                return;
+            }
+        }
+    }
+}
+
+inline
+void Hub::setHealthPolling(unsigned int rssiIntervalMs, unsigned int batteryIntervalMs, float jitter)
+{
+    _health.setIntervals(static_cast<uint64_t>(rssiIntervalMs) * 1000, static_cast<uint64_t>(batteryIntervalMs) * 1000,
+                         jitter);
+}
+
+inline
+void Hub::setHealthSink(DeviceHealthSink* sink)
+{
+    _healthSink = sink;
+}
+
+inline
+const DeviceHealth& Hub::health(const Myo* myo) const
+{
+    return _health.health(myo->_index);
+}
+
+inline
+void Hub::trackEvent(Myo* myo, const DeviceEvent& event)
+{
+    advanceClock(event.timestamp);
+
+    _health.onEvent(myo->_index, event);
+
+    switch (event.type) {
+    case libmyo_event_locked:
+        myo->_commands.forgetLock();
+        break;
+    case libmyo_event_disconnected:
+    case libmyo_event_unpaired:
+        myo->_commands.clear();
+        break;
+    default:
+        break;
+    }
+}
+
+inline
+void Hub::advanceClock(uint64_t timestamp)
+{
+    if (!_lastTimestamp) {
+        if (timestamp > _clock) {
+            _clock = timestamp;
+        }
+    } else if (timestamp > _lastTimestamp) {
+        // Time already credited while the link was quiet is part of this gap, so only the rest is added.
+        uint64_t elapsed = timestamp - _lastTimestamp;
+        _clock += elapsed > _idleCredit ? elapsed - _idleCredit : 0;
+    } else {
+        return;
+    }
+    _lastTimestamp = timestamp;
+    _idleCredit = 0;
+}
+
+inline
+void Hub::creditIdleTime(uint64_t lastTimestamp, unsigned int duration_ms)
+{
+    // Events are timestamped by the Myo, so without any the clock would stand still and queued commands and health
+    // requests would wait for the next event. Time spent in libmyo without one stands in for it.
+    if (_lastTimestamp == lastTimestamp) {
+        const uint64_t elapsed = static_cast<uint64_t>(duration_ms) * 1000;
+        _clock += elapsed;
+        _idleCredit += elapsed;
+    }
+}
+
+inline
+void Hub::serviceMyos(ErrorCode& error)
+{
+    if (_health.polling()) {
+        _health.poll(_myos, _clock, error);
+        if (error.failed()) {
+            return;
+        }
+    }
+
+    flushCommands(error);
+    if (error.failed()) {
+        return;
+    }
+
+    if (_healthSink) {
+        _health.publish(_healthSink);
+    }
+}
+
+inline
+const DeviceState& Hub::state(const Myo* myo) const
+{
+    return myo->_state;
+}
+
+inline
+void Hub::setRestoreOnConnect(bool restore)
+{
+    _restoreOnConnect = restore;
+}
+
+inline
+void Hub::trackState(Myo* myo, const DeviceEvent& event)
+{
+    DeviceState& state = myo->_state;
+
+    switch (event.type) {
+    case libmyo_event_emg:
+        if (!state.firstEmgTimestamp) {
+            state.firstEmgTimestamp = event.timestamp;
+        }
+        break;
+    case libmyo_event_paired:
+        state.paired = true;
+        break;
+    case libmyo_event_unpaired:
+        state.paired = false;
+        // An unpaired Myo is no longer connected either.
+        // Fall through.
+    case libmyo_event_disconnected:
+        state.connected = false;
+        state.armSynced = false;
+        state.unlocked = false;
+        state.arm = armUnknown;
+        state.xDirection = xDirectionUnknown;
+        break;
+    case libmyo_event_connected:
+        state.connected = true;
+        ++state.connections;
+        state.connectedTimestamp = event.timestamp;
+        state.firstEmgTimestamp = 0;
+        if (_restoreOnConnect) {
+            restoreState(myo);
+        }
+        break;
+    case libmyo_event_arm_synced:
+        state.armSynced = true;
+        state.arm = event.armSync.arm;
+        state.xDirection = event.armSync.xDirection;
+        state.rotation = event.armSync.rotation;
+        state.warmupState = event.armSync.warmupState;
+        break;
+    case libmyo_event_arm_unsynced:
+        state.armSynced = false;
+        state.arm = armUnknown;
+        state.xDirection = xDirectionUnknown;
+        break;
+    case libmyo_event_unlocked:
+        state.unlocked = true;
+        break;
+    case libmyo_event_locked:
+        state.unlocked = false;
+        break;
+    case libmyo_event_warmup_completed:
+        state.warmupResult = event.warmupResult;
+        break;
+    default:
+        break;
+    }
+}
+
+inline
+void Hub::restoreState(Myo* myo)
+{
+    // Called from within the event handler, so failures are counted rather than thrown. If commands are queued,
+    // these go out at the start of the next slice.
+    DeviceState& state = myo->_state;
+    ErrorCode error;
+    if (state.streamEmg) {
+        myo->setStreamEmg(Myo::streamEmgEnabled, error);
+        if (error.failed()) {
+            ++state.restoreFailures;
+        }
+    }
+    if (state.unlockHold) {
+        myo->unlock(Myo::unlockHold, error);
+        if (error.failed()) {
+            ++state.restoreFailures;
+        }
+    }
+}
+
+inline
+void Hub::setShard(std::size_t index, std::size_t count)
+{
+    _shardIndex = index;
+    _shardCount = count ? count : 1;
 }
 
 inline
@@ -94,14 +434,28 @@ void Hub::setLockingPolicy(LockingPolicy lockingPolicy)
     libmyo_set_locking_policy(_hub, static_cast<libmyo_locking_policy_t>(lockingPolicy), ThrowOnError());
 }
 
+inline
+void Hub::setLockingPolicy(LockingPolicy lockingPolicy, ErrorCode& error)
+{
+    libmyo_set_locking_policy(_hub, static_cast<libmyo_locking_policy_t>(lockingPolicy), error);
+}
+
 inline
 void Hub::onDeviceEvent(libmyo_event_t event)
 {
+    // Read the type and timestamp once for everything below; the payload is only read if someone consumes it.
+    DeviceEvent decoded;
+    decodeEventHeader(event, 0, decoded);
+    uint32_t type = decoded.type;
+    if (_observer) {
+        _observer->onEventReceived(type, decoded.timestamp);
+    }
+
     libmyo_myo_t opaqueMyo = libmyo_event_get_myo(event);
 
     Myo* myo = lookupMyo(opaqueMyo);
 
-    if (!myo && libmyo_event_get_type(event) == libmyo_event_paired) {
+    if (!myo && type == libmyo_event_paired && ownsMyo(opaqueMyo)) {
         myo = addMyo(opaqueMyo);
     }
 
@@ -109,101 +463,197 @@ void Hub::onDeviceEvent(libmyo_event_t event)
         // Ignore events for Myos we don't know about.
         return;
     }
+    decoded.myo = myo;
+
+    const std::vector<DeviceListener*>& listeners = eventListeners(type);
+    const bool consumed = _eventSink || !listeners.empty() || batchesEvent(type);
+    const bool tracked = _commandRate || _healthSink || _health.polling();
+
+    // Decode the payload once up front so that each listener, the device state and the health record are handed
+    // the same data without going back to libmyo. Nobody else needs it, so it is not read out of libmyo at all
+    // otherwise.
+    if (consumed || tracksPayload(type)) {
+        decodeEventPayload(event, decoded);
+    }
+
+    if (tracked) {
+        trackEvent(myo, decoded);
+    }
+
+    trackState(myo, decoded);
+
+    if (!consumed) {
+        return;
+    }
 
-    for (std::vector<DeviceListener*>::iterator I = _listeners.begin(), IE = _listeners.end(); I != IE; ++I) {
+    if (_eventSink) {
+        _eventSink->push(decoded);
+        return;
+    }
+
+    for (std::vector<DeviceListener*>::const_iterator I = listeners.begin(), IE = listeners.end(); I != IE; ++I) {
         DeviceListener* listener = *I;
 
+        if (_observer) {
+            _observer->onListenerBegin(listener, type);
+        }
+
         listener->onOpaqueEvent(event);
 
-        uint64_t time = libmyo_event_get_timestamp(event);
+        dispatchEvent(listener, decoded);
 
-        switch (libmyo_event_get_type(event)) {
-        case libmyo_event_paired: {
-            FirmwareVersion version = {libmyo_event_get_firmware_version(event, libmyo_version_major),
-                                       libmyo_event_get_firmware_version(event, libmyo_version_minor),
-                                       libmyo_event_get_firmware_version(event, libmyo_version_patch),
-                                       libmyo_event_get_firmware_version(event, libmyo_version_hardware_rev)};
-            listener->onPair(myo, time, version);
-            break;
+        if (_observer) {
+            _observer->onListenerEnd(listener, type);
         }
-        case libmyo_event_unpaired:
-            listener->onUnpair(myo, time);
-            break;
-        case libmyo_event_connected: {
-            FirmwareVersion version = {libmyo_event_get_firmware_version(event, libmyo_version_major),
-                                       libmyo_event_get_firmware_version(event, libmyo_version_minor),
-                                       libmyo_event_get_firmware_version(event, libmyo_version_patch),
-                                       libmyo_event_get_firmware_version(event, libmyo_version_hardware_rev)};
-            listener->onConnect(myo, time, version);
-            break;
+    }
+
+    batchEvent(decoded);
+
+    if (_observer) {
+        _observer->onEventHandled(type, decoded.timestamp);
+    }
+}
+
+inline
+bool Hub::batchesEvent(uint32_t type) const
+{
+    if (!_batchSize) {
+        return false;
+    }
+
+    switch (type) {
+    case libmyo_event_emg:
+        return !_eventListeners[emgBatchSlot].empty();
+    case libmyo_event_orientation:
+        return !_eventListeners[imuBatchSlot].empty();
+    case libmyo_event_disconnected:
+    case libmyo_event_unpaired:
+        // Batches are flushed when a Myo goes away.
+        return true;
+    default:
+        return false;
+    }
+}
+
+inline
+bool Hub::tracksPayload(uint32_t type) const
+{
+    switch (type) {
+    case libmyo_event_arm_synced:
+    case libmyo_event_warmup_completed:
+        // Kept in the DeviceState of every Myo.
+        return true;
+    case libmyo_event_rssi:
+    case libmyo_event_battery_level:
+        // Kept in the health record while events are tracked.
+        return _commandRate || _healthSink || _health.polling();
+    default:
+        return false;
+    }
+}
+
+inline
+void Hub::batchEvent(const DeviceEvent& event)
+{
+    if (!batchesEvent(event.type)) {
+        return;
+    }
+
+    // Batchers are indexed by Myo rather than looked up, and are only touched from the dispatching thread.
+    std::size_t index = event.myo->_index;
+    if (index >= _batchers.size()) {
+        _batchers.resize(index + 1);
+    }
+
+    SampleBatcher& batcher = _batchers[index];
+    if (batcher.capacity() != _batchSize) {
+        batcher.reset(event.myo, _batchSize);
+    }
+
+    switch (event.type) {
+    case libmyo_event_emg:
+        if (batcher.addEmg(event.timestamp, event.emg)) {
+            flushBatch(batcher);
         }
-        case libmyo_event_disconnected:
-            listener->onDisconnect(myo, time);
-            break;
-        case libmyo_event_arm_synced:
-            listener->onArmSync(myo, time,
-                                static_cast<Arm>(libmyo_event_get_arm(event)),
-                                static_cast<XDirection>(libmyo_event_get_x_direction(event)),
-                                libmyo_event_get_rotation_on_arm(event),
-                                static_cast<WarmupState>(libmyo_event_get_warmup_state(event)));
-            break;
-        case libmyo_event_arm_unsynced:
-            listener->onArmUnsync(myo, time);
-            break;
-        case libmyo_event_unlocked:
-            listener->onUnlock(myo, time);
-            break;
-        case libmyo_event_locked:
-            listener->onLock(myo, time);
-            break;
-        case libmyo_event_orientation:
-            listener->onOrientationData(myo, time,
-                                        Quaternion<float>(libmyo_event_get_orientation(event, libmyo_orientation_x),
-                                                          libmyo_event_get_orientation(event, libmyo_orientation_y),
-                                                          libmyo_event_get_orientation(event, libmyo_orientation_z),
-                                                          libmyo_event_get_orientation(event, libmyo_orientation_w)));
-            listener->onAccelerometerData(myo, time,
-                                          Vector3<float>(libmyo_event_get_accelerometer(event, 0),
-                                                         libmyo_event_get_accelerometer(event, 1),
-                                                         libmyo_event_get_accelerometer(event, 2)));
-
-            listener->onGyroscopeData(myo, time,
-                                      Vector3<float>(libmyo_event_get_gyroscope(event, 0),
-                                                     libmyo_event_get_gyroscope(event, 1),
-                                                     libmyo_event_get_gyroscope(event, 2)));
-
-            break;
-        case libmyo_event_pose:
-            listener->onPose(myo, time, Pose(static_cast<Pose::Type>(libmyo_event_get_pose(event))));
-            break;
-        case libmyo_event_rssi:
-            listener->onRssi(myo, time, libmyo_event_get_rssi(event));
-            break;
-        case libmyo_event_battery_level:
-            listener->onBatteryLevelReceived(myo, time, libmyo_event_get_battery_level(event));
-            break;
-        case libmyo_event_emg: {
-            int8_t emg[] = { libmyo_event_get_emg(event, 0),
-                             libmyo_event_get_emg(event, 1),
-                             libmyo_event_get_emg(event, 2),
-                             libmyo_event_get_emg(event, 3),
-                             libmyo_event_get_emg(event, 4),
-                             libmyo_event_get_emg(event, 5),
-                             libmyo_event_get_emg(event, 6),
-                             libmyo_event_get_emg(event, 7) };
-            listener->onEmgData(myo, time, emg);
-            break;
+        break;
+    case libmyo_event_orientation:
+        if (batcher.addImu(event.timestamp, event.imu)) {
+            flushBatch(batcher);
         }
-        case libmyo_event_warmup_completed: {
-            listener->onWarmupCompleted(myo, time, static_cast<WarmupResult>(libmyo_event_get_warmup_result(event)));
-            break;
+        break;
+    case libmyo_event_disconnected:
+    case libmyo_event_unpaired:
+        flushBatch(batcher);
+        break;
+    default:
+        break;
+    }
+}
+
+inline
+void Hub::flushBatch(SampleBatcher& batcher)
+{
+    if (batcher.emgSize()) {
+        EmgBatch batch = batcher.takeEmg();
+        const std::vector<DeviceListener*>& listeners = _eventListeners[emgBatchSlot];
+        for (std::vector<DeviceListener*>::const_iterator I = listeners.begin(), IE = listeners.end(); I != IE; ++I) {
+            if (_observer) {
+                _observer->onListenerBegin(*I, libmyo_event_emg);
+            }
+            (*I)->onEmgBatch(batcher.myo(), batch);
+            if (_observer) {
+                _observer->onListenerEnd(*I, libmyo_event_emg);
+            }
         }
+    }
+
+    if (batcher.imuSize()) {
+        ImuBatch batch = batcher.takeImu();
+        const std::vector<DeviceListener*>& listeners = _eventListeners[imuBatchSlot];
+        for (std::vector<DeviceListener*>::const_iterator I = listeners.begin(), IE = listeners.end(); I != IE; ++I) {
+            if (_observer) {
+                _observer->onListenerBegin(*I, libmyo_event_orientation);
+            }
+            (*I)->onImuBatch(batcher.myo(), batch);
+            if (_observer) {
+                _observer->onListenerEnd(*I, libmyo_event_orientation);
+            }
+        }
+    }
+}
+
+inline
+const std::vector<DeviceListener*>& Hub::eventListeners(uint32_t type) const
+{
+    // Event types beyond those libmyo defines share the last slot, which only listeners subscribed to allEvents
+    // occupy; they never reach the slots of the batch bits.
+    return _eventListeners[type < imuBatchSlot ? type : eventTypeSlots - 1];
+}
+
+inline
+void Hub::updateEventListeners()
+{
+    for (std::size_t type = 0; type < eventTypeSlots; ++type) {
+        std::vector<DeviceListener*>& listeners = _eventListeners[type];
+        listeners.clear();
+        for (std::size_t i = 0; i < _listeners.size(); ++i) {
+            if (_listenerEvents[i] & (1u << type)) {
+                listeners.push_back(_listeners[i]);
+            }
         }
     }
 }
 
 inline
 void Hub::run(unsigned int duration_ms)
+{
+    ErrorCode error;
+    run(duration_ms, error);
+    throwIfFailed(error);
+}
+
+inline
+void Hub::run(unsigned int duration_ms, ErrorCode& error)
 {
     struct local {
         static libmyo_handler_result_t handler(void* user_data, libmyo_event_t event) {
@@ -214,11 +664,44 @@ void Hub::run(unsigned int duration_ms)
             return libmyo_handler_continue;
         }
     };
-    libmyo_run(_hub, duration_ms, &local::handler, this, ThrowOnError());
+
+    if (!_commandRate && !_healthSink && !_health.polling()) {
+        flushCommands(error);
+        if (!error.failed()) {
+            libmyo_run(_hub, duration_ms, &local::handler, this, error);
+        }
+        return;
+    }
+
+    // Send what is due between slices, so that it neither waits for the whole duration nor goes out from within
+    // the handler.
+    do {
+        serviceMyos(error);
+        if (error.failed()) {
+            return;
+        }
+        unsigned int slice = duration_ms < commandSliceMs ? duration_ms : static_cast<unsigned int>(commandSliceMs);
+        uint64_t lastTimestamp = _lastTimestamp;
+        libmyo_run(_hub, slice, &local::handler, this, error);
+        creditIdleTime(lastTimestamp, slice);
+        duration_ms -= slice;
+    } while (duration_ms && !error.failed());
+
+    if (!error.failed()) {
+        serviceMyos(error);
+    }
 }
 
 inline
 void Hub::runOnce(unsigned int duration_ms)
+{
+    ErrorCode error;
+    runOnce(duration_ms, error);
+    throwIfFailed(error);
+}
+
+inline
+void Hub::runOnce(unsigned int duration_ms, ErrorCode& error)
 {
     struct local {
         static libmyo_handler_result_t handler(void* user_data, libmyo_event_t event) {
@@ -229,7 +712,17 @@ void Hub::runOnce(unsigned int duration_ms)
             return libmyo_handler_stop;
         }
     };
-    libmyo_run(_hub, duration_ms, &local::handler, this, ThrowOnError());
+
+    serviceMyos(error);
+    if (error.failed()) {
+        return;
+    }
+    uint64_t lastTimestamp = _lastTimestamp;
+    libmyo_run(_hub, duration_ms, &local::handler, this, error);
+    if ((_commandRate || _healthSink || _health.polling()) && !error.failed()) {
+        creditIdleTime(lastTimestamp, duration_ms);
+        serviceMyos(error);
+    }
 }
 
 inline
@@ -241,23 +734,36 @@ libmyo_hub_t Hub::libmyoObject()
 inline
 Myo* Hub::lookupMyo(libmyo_myo_t opaqueMyo) const
 {
-    Myo* myo = 0;
-    for (std::vector<Myo*>::const_iterator I = _myos.begin(), IE = _myos.end(); I != IE; ++I) {
-        if ((*I)->libmyoObject() == opaqueMyo) {
-            myo = *I;
-            break;
-        }
+    return _myoTable.find(opaqueMyo);
+}
+
+inline
+bool Hub::ownsMyo(libmyo_myo_t opaqueMyo) const
+{
+    if (_shardCount == 1) {
+        return true;
     }
 
-    return myo;
+    // Mix the address so that consecutive MAC addresses from one production batch spread over all shards.
+    uint64_t macAddress = libmyo_get_mac_address(opaqueMyo);
+    uint32_t h = static_cast<uint32_t>(macAddress) ^ static_cast<uint32_t>(macAddress >> 32);
+    h ^= h >> 16;
+    h *= 0x45d9f3bu;
+    h ^= h >> 16;
+    return h % _shardCount == _shardIndex;
 }
 
 inline
 Myo* Hub::addMyo(libmyo_myo_t opaqueMyo)
 {
-    Myo* myo = new Myo(opaqueMyo);
+    Myo* myo = new (_myoPool.allocate()) Myo(opaqueMyo);
+    myo->_index = _myos.size();
+    myo->_commands.setEnabled(_commandRate != 0);
+    myo->_state.paired = true;
+    _health.addMyo(myo->_index, libmyo_get_mac_address(opaqueMyo));
 
     _myos.push_back(myo);
+    _myoTable.insert(opaqueMyo, myo);
 
     return myo;
 }
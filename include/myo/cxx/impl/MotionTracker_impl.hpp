@@ -0,0 +1,166 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#include "../MotionTracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace myo {
+
+inline
+MotionTracker::MotionTracker(float stillAcceleration, float stillRotation, uint64_t stillTime,
+                             float velocityTimeConstant)
+: _stillAcceleration(stillAcceleration)
+, _stillRotation(stillRotation)
+, _stillTime(stillTime)
+, _velocityTimeConstant(velocityTimeConstant)
+, _tracks()
+, _batchRotation()
+, _batchAccel()
+{
+}
+
+inline
+void MotionTracker::reset()
+{
+    _tracks.clear();
+}
+
+inline
+MotionSample MotionTracker::motion(Myo* myo) const
+{
+    const Track* track = _tracks.find(myo);
+    if (!track || !track->started) {
+        MotionSample none = {0, Vector3<float>(), Vector3<float>(), Vector3<float>(), false};
+        return none;
+    }
+    return track->motion;
+}
+
+inline
+bool MotionTracker::isStationary(Myo* myo) const
+{
+    return motion(myo).stationary;
+}
+
+inline
+void MotionTracker::onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation)
+{
+    _tracks.get(myo).rotation = rotation;
+}
+
+inline
+void MotionTracker::onAccelerometerData(Myo* myo, uint64_t timestamp, const Vector3<float>& accel)
+{
+    _tracks.get(myo).accel = accel;
+}
+
+inline
+void MotionTracker::onGyroscopeData(Myo* myo, uint64_t timestamp, const Vector3<float>& gyro)
+{
+    // The gyroscope comes last of the three callbacks for an IMU sample.
+    Track& t = _tracks.get(myo);
+    update(myo, t, timestamp, t.rotation, rotate(t.rotation, t.accel), t.accel.magnitude(), gyro.magnitude());
+}
+
+inline
+void MotionTracker::onImuBatch(Myo* myo, const ImuBatch& batch)
+{
+    Track& t = _tracks.get(myo);
+    const std::size_t size = batch.size;
+    if (!size) {
+        return;
+    }
+
+    _batchRotation.resize(size);
+    _batchAccel.resize(size);
+    std::copy(batch.orientation[libmyo_orientation_x], batch.orientation[libmyo_orientation_x] + size,
+              _batchRotation.x());
+    std::copy(batch.orientation[libmyo_orientation_y], batch.orientation[libmyo_orientation_y] + size,
+              _batchRotation.y());
+    std::copy(batch.orientation[libmyo_orientation_z], batch.orientation[libmyo_orientation_z] + size,
+              _batchRotation.z());
+    std::copy(batch.orientation[libmyo_orientation_w], batch.orientation[libmyo_orientation_w] + size,
+              _batchRotation.w());
+    std::copy(batch.accelerometer[0], batch.accelerometer[0] + size, _batchAccel.x());
+    std::copy(batch.accelerometer[1], batch.accelerometer[1] + size, _batchAccel.y());
+    std::copy(batch.accelerometer[2], batch.accelerometer[2] + size, _batchAccel.z());
+
+    // Rotate the whole batch into the world frame in place.
+    rotate(_batchRotation, _batchAccel, _batchAccel);
+
+    const float* gx = batch.gyroscope[0];
+    const float* gy = batch.gyroscope[1];
+    const float* gz = batch.gyroscope[2];
+    const float* ax = batch.accelerometer[0];
+    const float* ay = batch.accelerometer[1];
+    const float* az = batch.accelerometer[2];
+    for (std::size_t i = 0; i < size; ++i) {
+        float accelMagnitude = std::sqrt(ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i]);
+        float rotationSpeed = std::sqrt(gx[i] * gx[i] + gy[i] * gy[i] + gz[i] * gz[i]);
+        update(myo, t, batch.timestamps[i], _batchRotation[i], _batchAccel[i], accelMagnitude, rotationSpeed);
+    }
+}
+
+inline
+void MotionTracker::update(Myo* myo, Track& track, uint64_t timestamp, const Quaternion<float>& rotation,
+                           const Vector3<float>& worldAccel, float accelMagnitude, float rotationSpeed)
+{
+    const float standardGravity = 9.80665f;
+
+    MotionSample& motion = track.motion;
+
+    float dt = 0;
+    // Gaps in the stream restart the velocity estimate.
+    if (track.started && timestamp > motion.timestamp && timestamp - motion.timestamp <= maxStreamGap) {
+        dt = (timestamp - motion.timestamp) * 1e-6f;
+    } else {
+        motion.velocity = Vector3<float>();
+        motion.linearAcceleration = Vector3<float>();
+        track.stillSince = timestamp;
+    }
+
+    // The third row of the rotation matrix is the world's up axis seen from the Myo.
+    float x = rotation.x(), y = rotation.y(), z = rotation.z(), w = rotation.w();
+    motion.gravity = Vector3<float>(2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y));
+
+    Vector3<float> linear(worldAccel.x() * standardGravity, worldAccel.y() * standardGravity,
+                          (worldAccel.z() - 1) * standardGravity);
+
+    bool still = std::fabs(accelMagnitude - 1) < _stillAcceleration && rotationSpeed < _stillRotation;
+    if (!still) {
+        track.stillSince = timestamp;
+    }
+    motion.stationary = still && timestamp - track.stillSince >= _stillTime;
+
+    if (motion.stationary) {
+        motion.velocity = Vector3<float>();
+    } else if (dt > 0) {
+        // Trapezoidal integration, followed by a leak that keeps drift bounded.
+        float decay = _velocityTimeConstant > 0 ? 1 - std::min(dt / _velocityTimeConstant, 1.0f) : 1;
+        const Vector3<float>& previous = motion.linearAcceleration;
+        motion.velocity = Vector3<float>((motion.velocity.x() + 0.5f * dt * (previous.x() + linear.x())) * decay,
+                                         (motion.velocity.y() + 0.5f * dt * (previous.y() + linear.y())) * decay,
+                                         (motion.velocity.z() + 0.5f * dt * (previous.z() + linear.z())) * decay);
+    }
+
+    motion.linearAcceleration = linear;
+    motion.timestamp = timestamp;
+    track.started = true;
+
+    onMotion(myo, motion);
+}
+
+inline
+void MotionTracker::onDisconnect(Myo* myo, uint64_t timestamp)
+{
+    _tracks.erase(myo);
+}
+
+inline
+void MotionTracker::onUnpair(Myo* myo, uint64_t timestamp)
+{
+    onDisconnect(myo, timestamp);
+}
+
+} // namespace myo
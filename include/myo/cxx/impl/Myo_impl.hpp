@@ -10,43 +10,133 @@ namespace myo {
 inline
 void Myo::vibrate(VibrationType type)
 {
-    libmyo_vibrate(_myo, static_cast<libmyo_vibration_type_t>(type), ThrowOnError());
+    if (!queue(CommandQueue::commandVibrate, type)) {
+        libmyo_vibrate(_myo, static_cast<libmyo_vibration_type_t>(type), ThrowOnError());
+    }
+}
+
+inline
+void Myo::vibrate(VibrationType type, ErrorCode& error)
+{
+    if (queue(CommandQueue::commandVibrate, type)) {
+        error.clear();
+    } else {
+        libmyo_vibrate(_myo, static_cast<libmyo_vibration_type_t>(type), error);
+    }
 }
 
 inline
 void Myo::requestRssi() const
 {
-    libmyo_request_rssi(_myo, ThrowOnError());
+    if (!queue(CommandQueue::commandRequestRssi, 0)) {
+        libmyo_request_rssi(_myo, ThrowOnError());
+    }
+}
+
+inline
+void Myo::requestRssi(ErrorCode& error) const
+{
+    if (queue(CommandQueue::commandRequestRssi, 0)) {
+        error.clear();
+    } else {
+        libmyo_request_rssi(_myo, error);
+    }
 }
 
 inline
 void Myo::requestBatteryLevel() const
 {
-    libmyo_request_battery_level(_myo, myo::ThrowOnError());
+    if (!queue(CommandQueue::commandRequestBatteryLevel, 0)) {
+        libmyo_request_battery_level(_myo, ThrowOnError());
+    }
+}
+
+inline
+void Myo::requestBatteryLevel(ErrorCode& error) const
+{
+    if (queue(CommandQueue::commandRequestBatteryLevel, 0)) {
+        error.clear();
+    } else {
+        libmyo_request_battery_level(_myo, error);
+    }
 }
 
 inline
 void Myo::unlock(UnlockType type)
 {
-    libmyo_myo_unlock(_myo, static_cast<libmyo_unlock_type_t>(type), ThrowOnError());
+    _state.unlockHold = type == unlockHold;
+    if (!queue(CommandQueue::commandLock, type)) {
+        libmyo_myo_unlock(_myo, static_cast<libmyo_unlock_type_t>(type), ThrowOnError());
+    }
+}
+
+inline
+void Myo::unlock(UnlockType type, ErrorCode& error)
+{
+    _state.unlockHold = type == unlockHold;
+    if (queue(CommandQueue::commandLock, type)) {
+        error.clear();
+    } else {
+        libmyo_myo_unlock(_myo, static_cast<libmyo_unlock_type_t>(type), error);
+    }
 }
 
 inline
 void Myo::lock()
 {
-    libmyo_myo_lock(_myo, ThrowOnError());
+    _state.unlockHold = false;
+    if (!queue(CommandQueue::commandLock, CommandQueue::lockValue)) {
+        libmyo_myo_lock(_myo, ThrowOnError());
+    }
+}
+
+inline
+void Myo::lock(ErrorCode& error)
+{
+    _state.unlockHold = false;
+    if (queue(CommandQueue::commandLock, CommandQueue::lockValue)) {
+        error.clear();
+    } else {
+        libmyo_myo_lock(_myo, error);
+    }
 }
 
 inline
 void Myo::notifyUserAction()
 {
-    libmyo_myo_notify_user_action(_myo, libmyo_user_action_single, ThrowOnError());
+    if (!queue(CommandQueue::commandNotifyUserAction, libmyo_user_action_single)) {
+        libmyo_myo_notify_user_action(_myo, libmyo_user_action_single, ThrowOnError());
+    }
+}
+
+inline
+void Myo::notifyUserAction(ErrorCode& error)
+{
+    if (queue(CommandQueue::commandNotifyUserAction, libmyo_user_action_single)) {
+        error.clear();
+    } else {
+        libmyo_myo_notify_user_action(_myo, libmyo_user_action_single, error);
+    }
 }
 
 inline
 void Myo::setStreamEmg(StreamEmgType type)
 {
-    libmyo_set_stream_emg(_myo, static_cast<libmyo_stream_emg_t>(type), ThrowOnError());
+    _state.streamEmg = type == streamEmgEnabled;
+    if (!queue(CommandQueue::commandStreamEmg, type)) {
+        libmyo_set_stream_emg(_myo, static_cast<libmyo_stream_emg_t>(type), ThrowOnError());
+    }
+}
+
+inline
+void Myo::setStreamEmg(StreamEmgType type, ErrorCode& error)
+{
+    _state.streamEmg = type == streamEmgEnabled;
+    if (queue(CommandQueue::commandStreamEmg, type)) {
+        error.clear();
+    } else {
+        libmyo_set_stream_emg(_myo, static_cast<libmyo_stream_emg_t>(type), error);
+    }
 }
 
 inline
@@ -58,10 +148,18 @@ libmyo_myo_t Myo::libmyoObject() const
 inline
 Myo::Myo(libmyo_myo_t myo)
 : _myo(myo)
+, _index(0)
+, _commands()
+, _state()
 {
     if (!_myo) {
-        throw std::invalid_argument("Cannot construct Myo instance with null pointer");
+        throwError(libmyo_error_invalid_argument, "Cannot construct Myo instance with null pointer");
     }
+
+    _state.arm = armUnknown;
+    _state.xDirection = xDirectionUnknown;
+    _state.warmupState = warmupStateUnknown;
+    _state.warmupResult = warmupResultUnknown;
 }
 
 inline
@@ -69,4 +167,14 @@ Myo::~Myo()
 {
 }
 
+inline
+bool Myo::queue(CommandQueue::Kind kind, int value) const
+{
+    if (!_commands.enabled()) {
+        return false;
+    }
+    _commands.push(kind, value);
+    return true;
+}
+
 } // namespace myo
@@ -0,0 +1,338 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#include "../PoseClassifier.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace myo {
+
+inline
+PoseClassifier::PoseClassifier(std::size_t window, std::size_t hop, float shrinkage, float minConfidence)
+: EmgFeatureExtractor(window, hop)
+, _shrinkage(shrinkage)
+, _minConfidence(minConfidence)
+, _recording(false)
+, _recordingPose(unknownPose)
+, _examples()
+, _scatter(featureCount * featureCount, 0.0)
+, _poses()
+, _weights()
+, _scales()
+, _biases()
+, _current()
+{
+    for (unsigned int i = 0; i < featureCount; ++i) {
+        _mean[i] = 0;
+        _inverseStdDev[i] = 1;
+    }
+}
+
+inline
+void PoseClassifier::featureVector(const EmgFeatures& features, float* out)
+{
+    for (unsigned int i = 0; i < 8; ++i) {
+        out[i] = features.rms[i];
+        out[8 + i] = features.mav[i];
+        out[16 + i] = features.zeroCrossings[i];
+        out[24 + i] = features.waveformLength[i];
+    }
+}
+
+inline
+void PoseClassifier::addExample(int pose, const EmgFeatures& features)
+{
+    float x[featureCount];
+    featureVector(features, x);
+
+    std::map<int, Examples>::iterator I = _examples.find(pose);
+    if (I == _examples.end()) {
+        Examples examples;
+        examples.count = 0;
+        for (unsigned int i = 0; i < featureCount; ++i) {
+            examples.sum[i] = 0;
+        }
+        I = _examples.insert(std::make_pair(pose, examples)).first;
+    }
+
+    Examples& examples = I->second;
+    ++examples.count;
+    for (unsigned int i = 0; i < featureCount; ++i) {
+        examples.sum[i] += x[i];
+        for (unsigned int j = 0; j < featureCount; ++j) {
+            _scatter[i * featureCount + j] += static_cast<double>(x[i]) * x[j];
+        }
+    }
+}
+
+inline
+void PoseClassifier::record(int pose)
+{
+    _recording = true;
+    _recordingPose = pose;
+}
+
+inline
+void PoseClassifier::stopRecording()
+{
+    _recording = false;
+}
+
+inline
+std::size_t PoseClassifier::exampleCount(int pose) const
+{
+    std::map<int, Examples>::const_iterator I = _examples.find(pose);
+    return I == _examples.end() ? 0 : I->second.count;
+}
+
+inline
+void PoseClassifier::clearExamples()
+{
+    _examples.clear();
+    _scatter.assign(featureCount * featureCount, 0.0);
+}
+
+inline
+void PoseClassifier::train()
+{
+    if (_examples.size() < 2) {
+        throw std::logic_error("Training a PoseClassifier requires examples of at least two poses");
+    }
+    if (_examples.size() > maxPoses) {
+        throw std::logic_error("A PoseClassifier cannot be trained on more than 64 poses");
+    }
+
+    const std::size_t n = featureCount;
+    const std::size_t poseCount = _examples.size();
+
+    // Standardize with the mean and standard deviation of all examples.
+    std::size_t total = 0;
+    double mean[featureCount] = {};
+    for (std::map<int, Examples>::const_iterator I = _examples.begin(), IE = _examples.end(); I != IE; ++I) {
+        total += I->second.count;
+        for (std::size_t i = 0; i < n; ++i) {
+            mean[i] += I->second.sum[i];
+        }
+    }
+    double scale[featureCount];
+    for (std::size_t i = 0; i < n; ++i) {
+        mean[i] /= total;
+        double variance = _scatter[i * n + i] / total - mean[i] * mean[i];
+        scale[i] = variance > 1e-12 ? 1 / std::sqrt(variance) : 0;
+    }
+
+    // Pooled within-pose covariance, in standardized units: the total scatter minus each pose's scatter about zero.
+    std::vector<double> covariance(_scatter);
+    std::vector<double> means(poseCount * n);
+    std::size_t k = 0;
+    for (std::map<int, Examples>::const_iterator I = _examples.begin(), IE = _examples.end(); I != IE; ++I, ++k) {
+        const Examples& examples = I->second;
+        double* poseMean = &means[k * n];
+        for (std::size_t i = 0; i < n; ++i) {
+            poseMean[i] = examples.sum[i] / examples.count;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                covariance[i * n + j] -= examples.count * poseMean[i] * poseMean[j];
+            }
+        }
+    }
+    double degreesOfFreedom = total > poseCount ? static_cast<double>(total - poseCount) : 1.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            double c = covariance[i * n + j] / degreesOfFreedom * scale[i] * scale[j];
+            covariance[i * n + j] = (1 - _shrinkage) * c + (i == j ? _shrinkage : 0.0);
+        }
+    }
+
+    if (!factor(covariance)) {
+        throw std::logic_error("The PoseClassifier examples are degenerate; increase the shrinkage");
+    }
+
+    std::vector<double> weights(poseCount * n);
+    std::vector<double> biases(poseCount);
+    for (k = 0; k < poseCount; ++k) {
+        double* w = &weights[k * n];
+        double* poseMean = &means[k * n];
+        for (std::size_t i = 0; i < n; ++i) {
+            poseMean[i] = (poseMean[i] - mean[i]) * scale[i];
+            w[i] = poseMean[i];
+        }
+        solve(covariance, w);
+        double product = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            product += poseMean[i] * w[i];
+        }
+        // Poses are taken to be equally likely, however long each was recorded for.
+        biases[k] = -0.5 * product;
+    }
+
+    // Quantize: standardized features become multiples of 1/inputScale, weights use the full 8-bit range per pose.
+    const float inputScale = 16;
+    _poses.clear();
+    _weights.assign(poseCount * n, 0);
+    _scales.assign(poseCount, 0);
+    _biases.assign(poseCount, 0);
+    k = 0;
+    for (std::map<int, Examples>::const_iterator I = _examples.begin(), IE = _examples.end(); I != IE; ++I, ++k) {
+        _poses.push_back(I->first);
+        const double* w = &weights[k * n];
+        double largest = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            largest = std::fabs(w[i]) > largest ? std::fabs(w[i]) : largest;
+        }
+        double step = largest > 0 ? largest / 127 : 1;
+        for (std::size_t i = 0; i < n; ++i) {
+            _weights[k * n + i] = static_cast<int8_t>(std::floor(w[i] / step + 0.5));
+        }
+        _scales[k] = static_cast<float>(step / inputScale);
+        _biases[k] = static_cast<float>(biases[k]);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        _mean[i] = static_cast<float>(mean[i]);
+        _inverseStdDev[i] = static_cast<float>(scale[i] * inputScale);
+    }
+}
+
+inline
+bool PoseClassifier::factor(std::vector<double>& matrix)
+{
+    // Replace the lower triangle of the symmetric matrix with its Cholesky factor L.
+    const std::size_t n = featureCount;
+    for (std::size_t j = 0; j < n; ++j) {
+        double diagonal = matrix[j * n + j];
+        for (std::size_t k = 0; k < j; ++k) {
+            diagonal -= matrix[j * n + k] * matrix[j * n + k];
+        }
+        if (diagonal <= 0) {
+            return false;
+        }
+        diagonal = std::sqrt(diagonal);
+        matrix[j * n + j] = diagonal;
+        for (std::size_t i = j + 1; i < n; ++i) {
+            double value = matrix[i * n + j];
+            for (std::size_t k = 0; k < j; ++k) {
+                value -= matrix[i * n + k] * matrix[j * n + k];
+            }
+            matrix[i * n + j] = value / diagonal;
+        }
+    }
+    return true;
+}
+
+inline
+void PoseClassifier::solve(const std::vector<double>& factor, double* vector)
+{
+    // Solve L y = b, then L^T x = y.
+    const std::size_t n = featureCount;
+    for (std::size_t i = 0; i < n; ++i) {
+        double value = vector[i];
+        for (std::size_t k = 0; k < i; ++k) {
+            value -= factor[i * n + k] * vector[k];
+        }
+        vector[i] = value / factor[i * n + i];
+    }
+    for (std::size_t i = n; i-- > 0;) {
+        double value = vector[i];
+        for (std::size_t k = i + 1; k < n; ++k) {
+            value -= factor[k * n + i] * vector[k];
+        }
+        vector[i] = value / factor[i * n + i];
+    }
+}
+
+inline
+int PoseClassifier::classify(const EmgFeatures& features, float* confidence) const
+{
+    if (_poses.empty()) {
+        if (confidence) {
+            *confidence = 0;
+        }
+        return unknownPose;
+    }
+
+    float x[featureCount];
+    featureVector(features, x);
+
+    int8_t quantized[featureCount];
+    for (unsigned int i = 0; i < featureCount; ++i) {
+        float value = (x[i] - _mean[i]) * _inverseStdDev[i];
+        value = value < -127 ? -127 : (value > 127 ? 127 : value);
+        quantized[i] = static_cast<int8_t>(value < 0 ? value - 0.5f : value + 0.5f);
+    }
+
+    float scores[maxPoses];
+    const std::size_t poseCount = _poses.size();
+    std::size_t best = 0;
+    for (std::size_t k = 0; k < poseCount; ++k) {
+        const int8_t* w = &_weights[k * featureCount];
+        int32_t dot = 0;
+        for (unsigned int i = 0; i < featureCount; ++i) {
+            dot += static_cast<int32_t>(quantized[i]) * w[i];
+        }
+        scores[k] = dot * _scales[k] + _biases[k];
+        if (scores[k] > scores[best]) {
+            best = k;
+        }
+    }
+
+    // Turn the scores into the probability of the best pose.
+    float sum = 0;
+    for (std::size_t k = 0; k < poseCount; ++k) {
+        sum += std::exp(scores[k] - scores[best]);
+    }
+    float probability = 1 / sum;
+    if (confidence) {
+        *confidence = probability;
+    }
+
+    return probability >= _minConfidence ? _poses[best] : static_cast<int>(unknownPose);
+}
+
+inline
+int PoseClassifier::pose(Myo* myo) const
+{
+    const int* current = _current.find(myo);
+    return current ? *current : static_cast<int>(unknownPose);
+}
+
+inline
+void PoseClassifier::onEmgFeatures(Myo* myo, const EmgFeatures& features)
+{
+    if (_recording) {
+        addExample(_recordingPose, features);
+    }
+
+    if (_poses.empty()) {
+        return;
+    }
+
+    float confidence = 0;
+    int recognized = classify(features, &confidence);
+
+    int* current = _current.find(myo);
+    if (!current) {
+        current = &_current.get(myo);
+        *current = unknownPose;
+    }
+    if (*current != recognized) {
+        *current = recognized;
+        onExtendedPose(myo, features.timestamp, recognized, confidence);
+    }
+}
+
+inline
+void PoseClassifier::onDisconnect(Myo* myo, uint64_t timestamp)
+{
+    _current.erase(myo);
+    EmgFeatureExtractor::onDisconnect(myo, timestamp);
+}
+
+inline
+void PoseClassifier::onUnpair(Myo* myo, uint64_t timestamp)
+{
+    _current.erase(myo);
+    EmgFeatureExtractor::onUnpair(myo, timestamp);
+}
+
+} // namespace myo
@@ -0,0 +1,108 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#include "../PoseTracker.hpp"
+
+namespace myo {
+
+inline
+PoseTracker::PoseTracker(uint64_t holdInterval)
+: _holdInterval(holdInterval)
+, _tracks()
+{
+}
+
+inline
+void PoseTracker::reset()
+{
+    _tracks.clear();
+}
+
+inline
+Pose PoseTracker::pose(Myo* myo) const
+{
+    const Track* track = _tracks.find(myo);
+    return track ? track->pose : Pose();
+}
+
+inline
+uint64_t PoseTracker::poseDuration(Myo* myo) const
+{
+    const Track* track = _tracks.find(myo);
+    return track ? track->latest - track->since : 0;
+}
+
+inline
+void PoseTracker::onPose(Myo* myo, uint64_t timestamp, Pose pose)
+{
+    Track* track = _tracks.find(myo);
+    if (!track) {
+        Track& entered = _tracks.get(myo);
+        entered.pose = pose;
+        entered.since = timestamp;
+        entered.latest = timestamp;
+        entered.holds = 0;
+        onPoseEnter(myo, timestamp, pose);
+        return;
+    }
+    if (track->pose == pose) {
+        return;
+    }
+
+    // Update the state before calling out, in case the callbacks reset the tracker.
+    Pose exited = track->pose;
+    uint64_t duration = timestamp > track->since ? timestamp - track->since : 0;
+    track->pose = pose;
+    track->since = timestamp;
+    track->latest = timestamp;
+    track->holds = 0;
+
+    onPoseExit(myo, timestamp, exited, duration);
+    onPoseEnter(myo, timestamp, pose);
+}
+
+inline
+void PoseTracker::onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation)
+{
+    // Nothing is held until a pose has been reported.
+    Track* track = _tracks.find(myo);
+    if (!track || timestamp <= track->latest) {
+        return;
+    }
+    track->latest = timestamp;
+
+    if (!_holdInterval || track->pose == Pose::rest || track->pose == Pose::unknown) {
+        return;
+    }
+    uint64_t duration = timestamp - track->since;
+    if (duration / _holdInterval > track->holds) {
+        track->holds = duration / _holdInterval;
+        onPoseHold(myo, timestamp, track->pose, duration);
+    }
+}
+
+inline
+void PoseTracker::exit(Myo* myo, uint64_t timestamp)
+{
+    const Track* track = _tracks.find(myo);
+    if (!track) {
+        return;
+    }
+    Pose exited = track->pose;
+    uint64_t duration = timestamp > track->since ? timestamp - track->since : 0;
+    _tracks.erase(myo);
+    onPoseExit(myo, timestamp, exited, duration);
+}
+
+inline
+void PoseTracker::onDisconnect(Myo* myo, uint64_t timestamp)
+{
+    exit(myo, timestamp);
+}
+
+inline
+void PoseTracker::onUnpair(Myo* myo, uint64_t timestamp)
+{
+    exit(myo, timestamp);
+}
+
+} // namespace myo
@@ -66,30 +66,36 @@ bool operator!=(Pose::Type type, Pose pose)
 inline
 std::string Pose::toString() const
 {
-    switch (type()) {
-    case Pose::rest:
-        return "rest";
-    case Pose::fist:
-        return "fist";
-    case Pose::waveIn:
-        return "waveIn";
-    case Pose::waveOut:
-        return "waveOut";
-    case Pose::fingersSpread:
-        return "fingersSpread";
-    case Pose::doubleTap:
-        return "doubleTap";
-    case Pose::unknown:
+    return name(_type);
+}
+
+inline
+const char* Pose::name() const
+{
+    return name(_type);
+}
+
+inline
+const char* Pose::name(Pose::Type type)
+{
+    // Indexed by the libmyo_pose_t values of all types except unknown.
+    static const char* const names[libmyo_num_poses] = {
+        "rest", "fist", "waveIn", "waveOut", "fingersSpread", "doubleTap"
+    };
+
+    if (type == Pose::unknown) {
         return "unknown";
     }
-
-    return "<invalid>";
+    if (static_cast<unsigned int>(type) >= libmyo_num_poses) {
+        return "<invalid>";
+    }
+    return names[type];
 }
 
 inline
 std::ostream& operator<<(std::ostream& out, const Pose& pose)
 {
-    return out << pose.toString();
+    return out << pose.name();
 }
 
 } // namespace myo
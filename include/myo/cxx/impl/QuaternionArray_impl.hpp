@@ -0,0 +1,234 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+
+#include "../QuaternionArray.hpp"
+
+#include <stdexcept>
+
+namespace myo {
+namespace simd {
+
+// Number of terms of the polynomial used to evaluate the slerp weights.
+const int slerpTerms = 16;
+
+// Fill \a coefficients with the coefficients of the polynomial p, such that sin(t * theta) / sin(theta) is
+// approximately t * p(cos(theta) - 1) for theta between 0 and pi / 2. The terms follow from the power series of
+// sin(t * theta) / sin(theta) in cos(theta) - 1; the last term is scaled to absorb the truncated remainder.
+inline void slerpCoefficients(float t, float* coefficients)
+{
+    double c = 1;
+    coefficients[0] = 1;
+    for (int i = 1; i < slerpTerms; ++i) {
+        c *= (static_cast<double>(t) * t - static_cast<double>(i) * i) / (i * (2.0 * i + 1));
+        coefficients[i] = static_cast<float>(i == slerpTerms - 1 ? c * 1.915 : c);
+    }
+}
+
+namespace scalar {
+typedef ScalarPack Pack;
+#include "../detail/QuaternionKernels.hpp"
+} // namespace scalar
+
+#if defined(MYO_SIMD_X86)
+
+namespace sse2 {
+typedef Sse2Pack Pack;
+#include "../detail/QuaternionKernels.hpp"
+} // namespace sse2
+
+#if defined(__clang__)
+# pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+# pragma GCC push_options
+# pragma GCC target("avx2,fma")
+#endif
+
+namespace avx2 {
+typedef Avx2Pack Pack;
+#include "../detail/QuaternionKernels.hpp"
+} // namespace avx2
+
+#if defined(__clang__)
+# pragma clang attribute pop
+#elif defined(__GNUC__)
+# pragma GCC pop_options
+#endif
+
+#endif // MYO_SIMD_X86
+
+// The kernels for one instruction set level.
+struct QuaternionKernels {
+    std::size_t width;
+    void (*multiply)(const float* const*, const float* const*, float* const*, std::size_t, std::size_t);
+    void (*normalize)(const float* const*, float* const*, std::size_t, std::size_t);
+    void (*conjugate)(const float* const*, float* const*, std::size_t, std::size_t);
+    void (*rotate)(const float* const*, const float* const*, float* const*, std::size_t, std::size_t);
+    void (*slerp)(const float* const*, const float* const*, float* const*, const float*, const float*, float, float,
+                  std::size_t, std::size_t);
+    void (*normalizeVectors)(const float* const*, float* const*, std::size_t, std::size_t);
+    void (*eulerAngles)(const float* const*, float* const*, std::size_t, std::size_t);
+    void (*eulerBuckets)(const float* const*, int* const*, float, std::size_t, std::size_t);
+};
+
+inline const QuaternionKernels& quaternionKernels(Level level)
+{
+    static const QuaternionKernels scalarKernels = {
+        1, scalar::multiplyQuaternions, scalar::normalizeQuaternions, scalar::conjugateQuaternions,
+        scalar::rotateVectors, scalar::slerpQuaternions, scalar::normalizeVectors,
+        scalar::eulerAngles, scalar::eulerBuckets
+    };
+#if defined(MYO_SIMD_X86)
+    static const QuaternionKernels sse2Kernels = {
+        4, sse2::multiplyQuaternions, sse2::normalizeQuaternions, sse2::conjugateQuaternions,
+        sse2::rotateVectors, sse2::slerpQuaternions, sse2::normalizeVectors,
+        sse2::eulerAngles, sse2::eulerBuckets
+    };
+    static const QuaternionKernels avx2Kernels = {
+        8, avx2::multiplyQuaternions, avx2::normalizeQuaternions, avx2::conjugateQuaternions,
+        avx2::rotateVectors, avx2::slerpQuaternions, avx2::normalizeVectors,
+        avx2::eulerAngles, avx2::eulerBuckets
+    };
+
+    switch (level) {
+    case levelAvx2:
+        return avx2Kernels;
+    case levelSse2:
+        return sse2Kernels;
+    default:
+        break;
+    }
+#endif
+    return scalarKernels;
+}
+
+inline Level& activeLevel()
+{
+    static Level level = detectLevel();
+    return level;
+}
+
+// Return the number of leading elements of \a size that the kernels for the active level process; the scalar
+// kernels handle the rest.
+inline std::size_t bodySize(const QuaternionKernels& kernels, std::size_t size)
+{
+    return size - size % kernels.width;
+}
+
+} // namespace simd
+
+inline
+simd::Level simdLevel()
+{
+    return simd::activeLevel();
+}
+
+inline
+void setSimdLevel(simd::Level level)
+{
+    simd::Level supported = simd::detectLevel();
+    simd::activeLevel() = level < supported ? level : supported;
+}
+
+inline
+void multiply(const QuaternionArray& lhs, const QuaternionArray& rhs, QuaternionArray& out)
+{
+    if (lhs.size() != rhs.size()) {
+        throw std::invalid_argument("Quaternion arrays differ in size");
+    }
+    out.resize(lhs.size());
+
+    const float* a[4] = {lhs.x(), lhs.y(), lhs.z(), lhs.w()};
+    const float* b[4] = {rhs.x(), rhs.y(), rhs.z(), rhs.w()};
+    float* result[4] = {out.x(), out.y(), out.z(), out.w()};
+
+    const simd::QuaternionKernels& kernels = simd::quaternionKernels(simdLevel());
+    std::size_t body = simd::bodySize(kernels, out.size());
+    kernels.multiply(a, b, result, 0, body);
+    simd::scalar::multiplyQuaternions(a, b, result, body, out.size());
+}
+
+inline
+void normalize(const QuaternionArray& quats, QuaternionArray& out)
+{
+    out.resize(quats.size());
+
+    const float* q[4] = {quats.x(), quats.y(), quats.z(), quats.w()};
+    float* result[4] = {out.x(), out.y(), out.z(), out.w()};
+
+    const simd::QuaternionKernels& kernels = simd::quaternionKernels(simdLevel());
+    std::size_t body = simd::bodySize(kernels, out.size());
+    kernels.normalize(q, result, 0, body);
+    simd::scalar::normalizeQuaternions(q, result, body, out.size());
+}
+
+inline
+void conjugate(const QuaternionArray& quats, QuaternionArray& out)
+{
+    out.resize(quats.size());
+
+    const float* q[4] = {quats.x(), quats.y(), quats.z(), quats.w()};
+    float* result[4] = {out.x(), out.y(), out.z(), out.w()};
+
+    const simd::QuaternionKernels& kernels = simd::quaternionKernels(simdLevel());
+    std::size_t body = simd::bodySize(kernels, out.size());
+    kernels.conjugate(q, result, 0, body);
+    simd::scalar::conjugateQuaternions(q, result, body, out.size());
+}
+
+inline
+void rotate(const QuaternionArray& quats, const Vector3Array& vecs, Vector3Array& out)
+{
+    if (quats.size() != vecs.size()) {
+        throw std::invalid_argument("Quaternion and vector arrays differ in size");
+    }
+    out.resize(vecs.size());
+
+    const float* q[4] = {quats.x(), quats.y(), quats.z(), quats.w()};
+    const float* v[3] = {vecs.x(), vecs.y(), vecs.z()};
+    float* result[3] = {out.x(), out.y(), out.z()};
+
+    const simd::QuaternionKernels& kernels = simd::quaternionKernels(simdLevel());
+    std::size_t body = simd::bodySize(kernels, out.size());
+    kernels.rotate(q, v, result, 0, body);
+    simd::scalar::rotateVectors(q, v, result, body, out.size());
+}
+
+inline
+void slerp(const QuaternionArray& from, const QuaternionArray& to, float t, QuaternionArray& out)
+{
+    if (from.size() != to.size()) {
+        throw std::invalid_argument("Quaternion arrays differ in size");
+    }
+    out.resize(from.size());
+
+    const float* a[4] = {from.x(), from.y(), from.z(), from.w()};
+    const float* b[4] = {to.x(), to.y(), to.z(), to.w()};
+    float* result[4] = {out.x(), out.y(), out.z(), out.w()};
+
+    float s = 1 - t;
+    float fromCoefficients[simd::slerpTerms];
+    float toCoefficients[simd::slerpTerms];
+    simd::slerpCoefficients(s, fromCoefficients);
+    simd::slerpCoefficients(t, toCoefficients);
+
+    const simd::QuaternionKernels& kernels = simd::quaternionKernels(simdLevel());
+    std::size_t body = simd::bodySize(kernels, out.size());
+    kernels.slerp(a, b, result, fromCoefficients, toCoefficients, s, t, 0, body);
+    simd::scalar::slerpQuaternions(a, b, result, fromCoefficients, toCoefficients, s, t, body, out.size());
+}
+
+inline
+void normalize(const Vector3Array& vecs, Vector3Array& out)
+{
+    out.resize(vecs.size());
+
+    const float* v[3] = {vecs.x(), vecs.y(), vecs.z()};
+    float* result[3] = {out.x(), out.y(), out.z()};
+
+    const simd::QuaternionKernels& kernels = simd::quaternionKernels(simdLevel());
+    std::size_t body = simd::bodySize(kernels, out.size());
+    kernels.normalizeVectors(v, result, 0, body);
+    simd::scalar::normalizeVectors(v, result, body, out.size());
+}
+
+} // namespace myo
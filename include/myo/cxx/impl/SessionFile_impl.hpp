@@ -0,0 +1,425 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#include "../SessionFile.hpp"
+
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+#include "../Myo.hpp"
+
+namespace myo {
+
+namespace session {
+
+static const char signature[8] = { 'M', 'Y', 'O', 'S', 'E', 'S', 0, 1 };
+
+static const uint32_t byteOrderMark = 0x01020304;
+
+struct Header {
+    char signature[8];
+    uint32_t byteOrderMark;
+    uint32_t reserved;
+};
+
+struct Trailer {
+    uint64_t indexOffset;
+    uint64_t chunkCount;
+    uint64_t deviceOffset;
+    uint64_t deviceCount;
+    char signature[8];
+};
+
+inline std::size_t padded(std::size_t size)
+{
+    return (size + 7) & ~static_cast<std::size_t>(7);
+}
+
+// Size of the columns of a chunk holding \a samples samples.
+inline std::size_t chunkBytes(uint32_t kind, std::size_t samples)
+{
+    if (kind == sessionChunkEmg) {
+        return padded(samples * sizeof(uint32_t)) + 8 * padded(samples);
+    }
+    return padded(samples * sizeof(uint32_t)) + 10 * padded(samples * sizeof(float));
+}
+
+} // namespace session
+
+inline
+SessionWriter::SessionWriter(const std::string& path, std::size_t chunkSize)
+: _file(std::fopen(path.c_str(), "wb"))
+, _offset(0)
+, _chunkSize(chunkSize ? chunkSize : 1)
+, _devices()
+, _macAddresses()
+, _index()
+, _deltas(_chunkSize)
+, _imu()
+{
+    if (!_file) {
+        throw std::runtime_error("Unable to open session file for writing: " + path);
+    }
+
+    session::Header header;
+    std::memcpy(header.signature, session::signature, sizeof(header.signature));
+    header.byteOrderMark = session::byteOrderMark;
+    header.reserved = 0;
+    writeBytes(&header, sizeof(header));
+}
+
+inline
+SessionWriter::~SessionWriter()
+{
+    try {
+        close();
+    } catch (const std::exception&) {
+        // Destructors must not throw; call close() explicitly to observe write errors.
+    }
+}
+
+inline
+void SessionWriter::close()
+{
+    if (!_file) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < _devices.slots(); ++i) {
+        if (Device* d = _devices.at(i)) {
+            flushEmg(*d);
+            flushImu(*d);
+        }
+    }
+
+    session::Trailer trailer;
+    trailer.indexOffset = _offset;
+    trailer.chunkCount = _index.size();
+    if (!_index.empty()) {
+        writeBytes(&_index[0], _index.size() * sizeof(SessionChunkInfo));
+    }
+    trailer.deviceOffset = _offset;
+    trailer.deviceCount = _macAddresses.size();
+    if (!_macAddresses.empty()) {
+        writeBytes(&_macAddresses[0], _macAddresses.size() * sizeof(uint64_t));
+    }
+    std::memcpy(trailer.signature, session::signature, sizeof(trailer.signature));
+    writeBytes(&trailer, sizeof(trailer));
+
+    std::fclose(_file);
+    _file = 0;
+}
+
+inline
+void SessionWriter::onPair(Myo* myo, uint64_t timestamp, FirmwareVersion firmwareVersion)
+{
+    device(myo);
+}
+
+inline
+void SessionWriter::onUnpair(Myo* myo, uint64_t timestamp)
+{
+    Device& d = device(myo);
+    flushEmg(d);
+    flushImu(d);
+}
+
+inline
+void SessionWriter::onDisconnect(Myo* myo, uint64_t timestamp)
+{
+    Device& d = device(myo);
+    flushEmg(d);
+    flushImu(d);
+}
+
+// A single libmyo orientation event is delivered as onOrientationData(), onAccelerometerData() and
+// onGyroscopeData(), in that order. The first two are buffered and the sample is stored by the last.
+
+inline
+void SessionWriter::onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation)
+{
+    _imu.orientation[0] = rotation.x();
+    _imu.orientation[1] = rotation.y();
+    _imu.orientation[2] = rotation.z();
+    _imu.orientation[3] = rotation.w();
+}
+
+inline
+void SessionWriter::onAccelerometerData(Myo* myo, uint64_t timestamp, const Vector3<float>& accel)
+{
+    for (unsigned int i = 0; i < 3; ++i) {
+        _imu.accelerometer[i] = accel[i];
+    }
+}
+
+inline
+void SessionWriter::onGyroscopeData(Myo* myo, uint64_t timestamp, const Vector3<float>& gyro)
+{
+    if (!_file) {
+        return;
+    }
+
+    for (unsigned int i = 0; i < 3; ++i) {
+        _imu.gyroscope[i] = gyro[i];
+    }
+
+    Device& d = device(myo);
+    if (d.samples.imuSize() && timestamp - d.firstImuTimestamp > 0xffffffffu) {
+        // The offset from the start of the chunk would not fit in 32 bits.
+        flushImu(d);
+    }
+    if (!d.samples.imuSize()) {
+        d.firstImuTimestamp = timestamp;
+    }
+    if (d.samples.addImu(timestamp, _imu)) {
+        flushImu(d);
+    }
+}
+
+inline
+void SessionWriter::onEmgData(Myo* myo, uint64_t timestamp, const int8_t* emg)
+{
+    if (!_file) {
+        return;
+    }
+
+    Device& d = device(myo);
+    if (d.samples.emgSize() && timestamp - d.firstEmgTimestamp > 0xffffffffu) {
+        // The offset from the start of the chunk would not fit in 32 bits.
+        flushEmg(d);
+    }
+    if (!d.samples.emgSize()) {
+        d.firstEmgTimestamp = timestamp;
+    }
+    if (d.samples.addEmg(timestamp, emg)) {
+        flushEmg(d);
+    }
+}
+
+inline
+SessionWriter::Device& SessionWriter::device(Myo* myo)
+{
+    Device* existing = _devices.find(myo);
+    if (existing) {
+        return *existing;
+    }
+
+    Device& d = _devices.get(myo);
+    d.index = static_cast<uint32_t>(_macAddresses.size());
+    d.firstEmgTimestamp = 0;
+    d.firstImuTimestamp = 0;
+    d.samples.reset(myo, _chunkSize);
+    _macAddresses.push_back(libmyo_get_mac_address(myo->libmyoObject()));
+    return d;
+}
+
+inline
+void SessionWriter::flushEmg(Device& device)
+{
+    if (!device.samples.emgSize() || !_file) {
+        return;
+    }
+
+    EmgBatch batch = device.samples.takeEmg();
+
+    SessionChunkInfo info = SessionChunkInfo();
+    info.kind = sessionChunkEmg;
+    info.device = device.index;
+    info.size = static_cast<uint32_t>(batch.size);
+    info.firstTimestamp = batch.timestamps[0];
+    info.lastTimestamp = batch.timestamps[batch.size - 1];
+    for (std::size_t i = 0; i < batch.size; ++i) {
+        _deltas[i] = static_cast<uint32_t>(batch.timestamps[i] - info.firstTimestamp);
+    }
+    for (unsigned int c = 0; c < 8; ++c) {
+        int8_t minimum = batch.channels[c][0];
+        int8_t maximum = minimum;
+        for (std::size_t i = 1; i < batch.size; ++i) {
+            int8_t value = batch.channels[c][i];
+            minimum = value < minimum ? value : minimum;
+            maximum = value > maximum ? value : maximum;
+        }
+        info.minimum[c] = minimum;
+        info.maximum[c] = maximum;
+    }
+
+    const void* columns[8];
+    for (unsigned int c = 0; c < 8; ++c) {
+        columns[c] = batch.channels[c];
+    }
+    writeChunk(info, &_deltas[0], columns, 8, sizeof(int8_t));
+}
+
+inline
+void SessionWriter::flushImu(Device& device)
+{
+    if (!device.samples.imuSize() || !_file) {
+        return;
+    }
+
+    ImuBatch batch = device.samples.takeImu();
+
+    const float* columns[10];
+    for (unsigned int c = 0; c < 4; ++c) {
+        columns[c] = batch.orientation[c];
+    }
+    for (unsigned int c = 0; c < 3; ++c) {
+        columns[4 + c] = batch.accelerometer[c];
+        columns[7 + c] = batch.gyroscope[c];
+    }
+
+    SessionChunkInfo info = SessionChunkInfo();
+    info.kind = sessionChunkImu;
+    info.device = device.index;
+    info.size = static_cast<uint32_t>(batch.size);
+    info.firstTimestamp = batch.timestamps[0];
+    info.lastTimestamp = batch.timestamps[batch.size - 1];
+    for (std::size_t i = 0; i < batch.size; ++i) {
+        _deltas[i] = static_cast<uint32_t>(batch.timestamps[i] - info.firstTimestamp);
+    }
+    for (unsigned int c = 0; c < 10; ++c) {
+        float minimum = columns[c][0];
+        float maximum = minimum;
+        for (std::size_t i = 1; i < batch.size; ++i) {
+            float value = columns[c][i];
+            minimum = value < minimum ? value : minimum;
+            maximum = value > maximum ? value : maximum;
+        }
+        info.minimum[c] = minimum;
+        info.maximum[c] = maximum;
+    }
+
+    const void* untyped[10];
+    for (unsigned int c = 0; c < 10; ++c) {
+        untyped[c] = columns[c];
+    }
+    writeChunk(info, &_deltas[0], untyped, 10, sizeof(float));
+}
+
+inline
+void SessionWriter::writeChunk(SessionChunkInfo& info, const uint32_t* deltas, const void* const* columns,
+                               std::size_t columnCount, std::size_t valueSize)
+{
+    info.offset = _offset;
+    _index.push_back(info);
+
+    writeBytes(deltas, info.size * sizeof(uint32_t));
+    pad();
+    for (std::size_t c = 0; c < columnCount; ++c) {
+        writeBytes(columns[c], info.size * valueSize);
+        pad();
+    }
+}
+
+inline
+void SessionWriter::writeBytes(const void* data, std::size_t size)
+{
+    if (std::fwrite(data, 1, size, _file) != size) {
+        throw std::runtime_error("Unable to write session file");
+    }
+    _offset += size;
+}
+
+inline
+void SessionWriter::pad()
+{
+    static const char zeros[8] = { 0 };
+    writeBytes(zeros, session::padded(static_cast<std::size_t>(_offset)) - static_cast<std::size_t>(_offset));
+}
+
+inline
+SessionReader::SessionReader(const std::string& path)
+: _file(path)
+, _index(0)
+, _chunkCount(0)
+, _devices()
+{
+    const unsigned char* data = _file.data();
+    const std::size_t size = _file.size();
+
+    session::Header header;
+    session::Trailer trailer;
+    if (size < sizeof(header) + sizeof(trailer)) {
+        throw std::runtime_error("Not a complete session file: " + path);
+    }
+    std::memcpy(&header, data, sizeof(header));
+    std::memcpy(&trailer, data + size - sizeof(trailer), sizeof(trailer));
+
+    if (std::memcmp(header.signature, session::signature, sizeof(header.signature)) != 0
+        || std::memcmp(trailer.signature, session::signature, sizeof(trailer.signature)) != 0) {
+        throw std::runtime_error("Not a complete session file: " + path);
+    }
+    if (header.byteOrderMark != session::byteOrderMark) {
+        throw std::runtime_error("Session file was written with a different byte order: " + path);
+    }
+
+    const uint64_t end = size - sizeof(trailer);
+    if (trailer.indexOffset % 8 != 0 || trailer.indexOffset > end
+        || trailer.chunkCount > (end - trailer.indexOffset) / sizeof(SessionChunkInfo)
+        || trailer.deviceOffset != trailer.indexOffset + trailer.chunkCount * sizeof(SessionChunkInfo)
+        || trailer.deviceCount != (end - trailer.deviceOffset) / sizeof(uint64_t)) {
+        throw std::runtime_error("Malformed session file index: " + path);
+    }
+
+    _index = reinterpret_cast<const SessionChunkInfo*>(data + trailer.indexOffset);
+    _chunkCount = static_cast<std::size_t>(trailer.chunkCount);
+    _devices.resize(static_cast<std::size_t>(trailer.deviceCount));
+    if (!_devices.empty()) {
+        std::memcpy(&_devices[0], data + trailer.deviceOffset, _devices.size() * sizeof(uint64_t));
+    }
+
+    for (std::size_t i = 0; i < _chunkCount; ++i) {
+        const SessionChunkInfo& info = _index[i];
+        if ((info.kind != sessionChunkEmg && info.kind != sessionChunkImu) || info.device >= _devices.size()
+            || info.offset % 8 != 0 || info.offset > trailer.indexOffset
+            || session::chunkBytes(info.kind, info.size) > trailer.indexOffset - info.offset) {
+            throw std::runtime_error("Malformed session file chunk: " + path);
+        }
+    }
+}
+
+inline
+EmgSpan SessionReader::emg(std::size_t i) const
+{
+    const SessionChunkInfo& info = _index[i];
+    if (info.kind != sessionChunkEmg) {
+        throw std::invalid_argument("Session chunk does not hold EMG samples");
+    }
+
+    const unsigned char* data = _file.data() + info.offset;
+
+    EmgSpan span;
+    span._size = info.size;
+    span._firstTimestamp = info.firstTimestamp;
+    span._deltas = reinterpret_cast<const uint32_t*>(data);
+    data += session::padded(info.size * sizeof(uint32_t));
+    for (unsigned int c = 0; c < 8; ++c) {
+        span._channels[c] = reinterpret_cast<const int8_t*>(data);
+        data += session::padded(info.size);
+    }
+    return span;
+}
+
+inline
+ImuSpan SessionReader::imu(std::size_t i) const
+{
+    const SessionChunkInfo& info = _index[i];
+    if (info.kind != sessionChunkImu) {
+        throw std::invalid_argument("Session chunk does not hold IMU samples");
+    }
+
+    const unsigned char* data = _file.data() + info.offset;
+
+    ImuSpan span;
+    span._size = info.size;
+    span._firstTimestamp = info.firstTimestamp;
+    span._deltas = reinterpret_cast<const uint32_t*>(data);
+    data += session::padded(info.size * sizeof(uint32_t));
+    for (unsigned int c = 0; c < 10; ++c) {
+        span._columns[c] = reinterpret_cast<const float*>(data);
+        data += session::padded(info.size * sizeof(float));
+    }
+    return span;
+}
+
+} // namespace myo
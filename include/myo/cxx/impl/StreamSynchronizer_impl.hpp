@@ -0,0 +1,398 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#include "../StreamSynchronizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace myo {
+
+inline
+double StreamSynchronizer::SampleClock::update(uint64_t timestamp, double rate)
+{
+    // Gaps in the stream restart the clock.
+    const double maxGap = static_cast<double>(maxStreamGap);
+    // Gain of the phase correction: the clock follows a change of phase within a few dozen samples.
+    const double gain = 0.05;
+    // Weight lost by each older sample in the fit of the rate, for a fit over the last thousand samples or so.
+    const double forgetting = 0.999;
+
+    const double measured = static_cast<double>(timestamp);
+    const double period = nominal * rate;
+    double error = measured - (time + period);
+    if (!started || error > maxGap || error < -maxGap) {
+        started = true;
+        time = measured;
+        offset = 0;
+        jitter = 0;
+        reference = measured;
+        weight = 1;
+        sumX = sumY = sumXX = sumXY = 0;
+        return time;
+    }
+
+    // Lost samples delay the next one by whole periods. Smaller delays are transport jitter.
+    double steps = 1;
+    if (error > 0.5 * period + 2 * jitter) {
+        steps += std::floor(error / period + 0.5);
+        error -= (steps - 1) * period;
+    }
+
+    // Advance by the samples taken and move part of the way towards the timestamp. Sample times must increase for
+    // the history to be searchable.
+    time += std::max(steps * period + gain * error, 0.5 * period);
+    offset = time - measured;
+    jitter += (std::fabs(error) - jitter) / 64;
+
+    // The rate is fitted to the timestamps against the sample numbers, both relative to the newest sample so that
+    // they stay small: move the origin to the new sample, then age the older ones.
+    const double k = steps;
+    const double d = measured - reference;
+    sumXY = sumXY - k * sumY - d * sumX + k * d * weight;
+    sumXX = sumXX - 2 * k * sumX + k * k * weight;
+    sumX -= k * weight;
+    sumY -= d * weight;
+    weight = weight * forgetting + 1;
+    sumX *= forgetting;
+    sumY *= forgetting;
+    sumXX *= forgetting;
+    sumXY *= forgetting;
+    reference = measured;
+
+    return time;
+}
+
+inline
+bool StreamSynchronizer::SampleClock::fitted() const
+{
+    // The rate is only fitted once this much weight has been accumulated.
+    const double minWeight = 32;
+    return started && weight >= minWeight && weight * sumXX - sumX * sumX > 0;
+}
+
+inline
+double StreamSynchronizer::SampleClock::rate() const
+{
+    if (!fitted()) {
+        return 1;
+    }
+    // Real sample clocks are within a fraction of a percent of nominal.
+    double slope = (weight * sumXY - sumX * sumY) / (weight * sumXX - sumX * sumX);
+    return std::min(std::max(slope / nominal, 0.99), 1.01);
+}
+
+inline
+StreamClock StreamSynchronizer::SampleClock::estimate(double rate) const
+{
+    StreamClock clock = {0, 0, 0, 0};
+    if (started) {
+        clock.period = nominal * rate;
+        clock.drift = (rate - 1) * 1e6;
+        clock.offset = offset;
+        clock.jitter = jitter;
+    }
+    return clock;
+}
+
+inline
+double StreamSynchronizer::Track::rate() const
+{
+    // Both streams run off the armband's crystal. IMU samples are far apart compared to the transport jitter, so
+    // their sample numbers, and hence the fitted rate, are more reliable.
+    return imu.clock.fitted() ? imu.clock.rate() : emg.clock.rate();
+}
+
+template<typename Slot>
+inline
+void StreamSynchronizer::History<Slot>::push(const Slot& slot)
+{
+    // A clock that restarted behind the history invalidates it.
+    if (count && slot.time <= slots[newest].time) {
+        count = 0;
+    }
+    newest = newest + 1 == slots.size() ? 0 : newest + 1;
+    slots[newest] = slot;
+    count = std::min(count + 1, slots.size());
+}
+
+template<typename Slot>
+inline
+bool StreamSynchronizer::History<Slot>::find(double time, const Slot*& before, const Slot*& after,
+                                             float& fraction) const
+{
+    // Samples further apart than this have lost data between them.
+    const double maxGap = static_cast<double>(maxStreamGap);
+
+    if (!count || slots[newest].time < time) {
+        return false;
+    }
+
+    // Frames are usually close to the newest samples, so search backwards.
+    std::size_t index = newest;
+    for (std::size_t age = 1; age < count; ++age) {
+        std::size_t older = index ? index - 1 : slots.size() - 1;
+        if (slots[older].time <= time) {
+            before = &slots[older];
+            after = &slots[index];
+            if (after->time - before->time > maxGap) {
+                return false;
+            }
+            fraction = static_cast<float>((time - before->time) / (after->time - before->time));
+            return true;
+        }
+        index = older;
+    }
+
+    // Only the oldest sample is left; it matches only if it is exactly at the time.
+    if (slots[index].time == time) {
+        before = after = &slots[index];
+        fraction = 0;
+        return true;
+    }
+    return false;
+}
+
+inline
+StreamSynchronizer::StreamSynchronizer(uint64_t framePeriod, uint64_t maxLatency)
+: _framePeriod(framePeriod)
+, _maxLatency(maxLatency)
+, _next(0)
+, _tracks()
+, _order()
+, _ordered()
+, _frame()
+{
+    if (framePeriod == 0) {
+        throw std::invalid_argument("The frame period of a StreamSynchronizer must be at least one microsecond");
+    }
+}
+
+inline
+void StreamSynchronizer::reset()
+{
+    _tracks.clear();
+    _order.clear();
+    _ordered.clear();
+    _next = 0;
+}
+
+inline
+StreamClock StreamSynchronizer::emgClock(Myo* myo) const
+{
+    const Track* track = _tracks.find(myo);
+    if (!track) {
+        StreamClock none = {0, 0, 0, 0};
+        return none;
+    }
+    return track->emg.clock.estimate(track->rate());
+}
+
+inline
+StreamClock StreamSynchronizer::imuClock(Myo* myo) const
+{
+    const Track* track = _tracks.find(myo);
+    if (!track) {
+        StreamClock none = {0, 0, 0, 0};
+        return none;
+    }
+    return track->imu.clock.estimate(track->rate());
+}
+
+inline
+StreamSynchronizer::Track& StreamSynchronizer::track(Myo* myo)
+{
+    // Nominal sample periods of the EMG and IMU streams, in microseconds.
+    const double emgPeriod = 5000;
+    const double imuPeriod = 20000;
+
+    Track* existing = _tracks.find(myo);
+    if (existing) {
+        return *existing;
+    }
+
+    Track& track = _tracks.get(myo);
+    track.myo = myo;
+
+    // Frames can be up to twice the latency behind the newest sample, see emitFrames().
+    SampleClock clock = {0, 0, 0, 0, false, 0, 0, 0, 0, 0, 0};
+    clock.nominal = emgPeriod;
+    track.emg.clock = clock;
+    track.emg.slots.resize(static_cast<std::size_t>(2 * _maxLatency / emgPeriod) + 4);
+    track.emg.newest = 0;
+    track.emg.count = 0;
+    clock.nominal = imuPeriod;
+    track.imu.clock = clock;
+    track.imu.slots.resize(static_cast<std::size_t>(2 * _maxLatency / imuPeriod) + 4);
+    track.imu.newest = 0;
+    track.imu.count = 0;
+
+    ImuSlot pending = {0, {0, 0, 0, 1}, {0, 0, 0}, {0, 0, 0}};
+    track.pending = pending;
+
+    _order.push_back(myo);
+    updateOrder();
+    return track;
+}
+
+// Starting or dropping a track may move the others, so the tracks are looked up again in frame order.
+inline
+void StreamSynchronizer::updateOrder()
+{
+    _ordered.resize(_order.size());
+    for (std::size_t i = 0; i < _order.size(); ++i) {
+        _ordered[i] = _tracks.find(_order[i]);
+    }
+    _frame.resize(_order.size());
+}
+
+inline
+void StreamSynchronizer::onEmgData(Myo* myo, uint64_t timestamp, const int8_t* emg)
+{
+    Track& t = track(myo);
+    EmgSlot slot;
+    slot.time = t.emg.clock.update(timestamp, t.rate());
+    for (unsigned int i = 0; i < 8; ++i) {
+        slot.emg[i] = emg[i];
+    }
+    t.emg.push(slot);
+    emitFrames();
+}
+
+inline
+void StreamSynchronizer::onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation)
+{
+    ImuSlot& pending = track(myo).pending;
+    pending.orientation[0] = rotation.x();
+    pending.orientation[1] = rotation.y();
+    pending.orientation[2] = rotation.z();
+    pending.orientation[3] = rotation.w();
+}
+
+inline
+void StreamSynchronizer::onAccelerometerData(Myo* myo, uint64_t timestamp, const Vector3<float>& accel)
+{
+    ImuSlot& pending = track(myo).pending;
+    pending.accel[0] = accel.x();
+    pending.accel[1] = accel.y();
+    pending.accel[2] = accel.z();
+}
+
+inline
+void StreamSynchronizer::onGyroscopeData(Myo* myo, uint64_t timestamp, const Vector3<float>& gyro)
+{
+    // The gyroscope comes last of the three callbacks for an IMU sample.
+    Track& t = track(myo);
+    t.pending.gyro[0] = gyro.x();
+    t.pending.gyro[1] = gyro.y();
+    t.pending.gyro[2] = gyro.z();
+    t.pending.time = t.imu.clock.update(timestamp, t.rate());
+    t.imu.push(t.pending);
+    emitFrames();
+}
+
+inline
+void StreamSynchronizer::emitFrames()
+{
+    double newest = 0;
+    for (std::vector<Track*>::const_iterator I = _ordered.begin(), IE = _ordered.end(); I != IE; ++I) {
+        newest = std::max(newest, std::max((*I)->emg.latest(), (*I)->imu.latest()));
+    }
+    const double latency = static_cast<double>(_maxLatency);
+
+    // Start on the first frame after the first sample, and skip ahead over gaps in all streams rather than
+    // delivering the frames in between, which would have no data.
+    if (!_next || newest - _next > 2 * latency) {
+        double start = _next ? newest - 2 * latency : newest;
+        _next = (static_cast<uint64_t>(start) / _framePeriod + 1) * _framePeriod;
+    }
+
+    for (;;) {
+        const double time = static_cast<double>(_next);
+
+        // Wait for every stream that is still active to pass the frame, up to the latency bound.
+        bool ready = true;
+        for (std::vector<Track*>::const_iterator I = _ordered.begin(), IE = _ordered.end(); I != IE && ready; ++I) {
+            const Track& t = **I;
+            if ((t.emg.count && t.emg.latest() >= newest - latency && t.emg.latest() < time)
+                || (t.imu.count && t.imu.latest() >= newest - latency && t.imu.latest() < time)) {
+                ready = false;
+            }
+        }
+        if (!ready && newest - time <= latency) {
+            return;
+        }
+
+        for (std::size_t i = 0; i < _ordered.size(); ++i) {
+            resample(*_ordered[i], time, _frame[i]);
+        }
+        SyncedFrame frame;
+        frame.timestamp = _next;
+        frame.size = _frame.size();
+        frame.samples = _frame.empty() ? 0 : &_frame[0];
+        _next += _framePeriod;
+        onSyncedFrame(frame);
+    }
+}
+
+inline
+void StreamSynchronizer::resample(const Track& track, double time, SyncedSample& sample) const
+{
+    sample.myo = track.myo;
+
+    const EmgSlot* emgBefore = 0;
+    const EmgSlot* emgAfter = 0;
+    float f = 0;
+    sample.hasEmg = track.emg.find(time, emgBefore, emgAfter, f);
+    for (unsigned int i = 0; i < 8; ++i) {
+        sample.emg[i] = sample.hasEmg ? emgBefore->emg[i] + (emgAfter->emg[i] - emgBefore->emg[i]) * f : 0;
+    }
+
+    const ImuSlot* imuBefore = 0;
+    const ImuSlot* imuAfter = 0;
+    sample.hasImu = track.imu.find(time, imuBefore, imuAfter, f);
+    if (!sample.hasImu) {
+        sample.orientation = Quaternion<float>();
+        sample.accel = Vector3<float>();
+        sample.gyro = Vector3<float>();
+        return;
+    }
+
+    // Normalized linear interpolation along the shorter arc; samples are close enough together that it is
+    // indistinguishable from spherical interpolation.
+    const float* a = imuBefore->orientation;
+    const float* b = imuAfter->orientation;
+    float sign = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0 ? -1.0f : 1.0f;
+    float q[4];
+    for (unsigned int i = 0; i < 4; ++i) {
+        q[i] = a[i] + (sign * b[i] - a[i]) * f;
+    }
+    sample.orientation = Quaternion<float>(q[0], q[1], q[2], q[3]).normalized();
+
+    const float* ca = imuBefore->accel;
+    const float* cb = imuAfter->accel;
+    sample.accel = Vector3<float>(ca[0] + (cb[0] - ca[0]) * f, ca[1] + (cb[1] - ca[1]) * f,
+                                  ca[2] + (cb[2] - ca[2]) * f);
+    const float* ga = imuBefore->gyro;
+    const float* gb = imuAfter->gyro;
+    sample.gyro = Vector3<float>(ga[0] + (gb[0] - ga[0]) * f, ga[1] + (gb[1] - ga[1]) * f,
+                                 ga[2] + (gb[2] - ga[2]) * f);
+}
+
+inline
+void StreamSynchronizer::onDisconnect(Myo* myo, uint64_t timestamp)
+{
+    if (!_tracks.erase(myo)) {
+        return;
+    }
+    _order.erase(std::find(_order.begin(), _order.end(), myo));
+    updateOrder();
+}
+
+inline
+void StreamSynchronizer::onUnpair(Myo* myo, uint64_t timestamp)
+{
+    onDisconnect(myo, timestamp);
+}
+
+} // namespace myo
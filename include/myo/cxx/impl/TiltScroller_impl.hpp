@@ -0,0 +1,130 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#include "../TiltScroller.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "../EulerAngles.hpp"
+
+namespace myo {
+
+inline
+TiltScroller::TiltScroller(float deadZone, float fullTilt, float minRate, float maxRate, float exponent, Axis axis)
+: _deadZone(deadZone)
+, _fullTilt(fullTilt)
+, _minRate(minRate)
+, _maxRate(maxRate)
+, _exponent(exponent)
+, _axis(axis)
+, _tracks()
+{
+    if (!(fullTilt > deadZone)) {
+        throw std::invalid_argument("The full tilt of a TiltScroller must be larger than its dead zone");
+    }
+    if (!(maxRate >= minRate)) {
+        throw std::invalid_argument("The maximum scroll rate must not be smaller than the minimum rate");
+    }
+}
+
+inline
+void TiltScroller::reset()
+{
+    _tracks.clear();
+}
+
+inline
+void TiltScroller::setNeutral(Myo* myo)
+{
+    Track& t = _tracks.get(myo);
+    t.neutral = t.angle;
+    t.direction = 0;
+    t.progress = 0;
+}
+
+inline
+float TiltScroller::tilt(Myo* myo) const
+{
+    const Track* track = _tracks.find(myo);
+    return track ? wrapAngle(track->angle - track->neutral) : 0;
+}
+
+inline
+float TiltScroller::rate(Myo* myo) const
+{
+    return rateFor(tilt(myo));
+}
+
+inline
+float TiltScroller::wrapAngle(float angle)
+{
+    const float pi = 3.14159265f;
+    if (angle > pi) {
+        return angle - 2 * pi;
+    } else if (angle < -pi) {
+        return angle + 2 * pi;
+    }
+    return angle;
+}
+
+inline
+float TiltScroller::rateFor(float tilt) const
+{
+    float magnitude = std::fabs(tilt);
+    if (magnitude <= _deadZone) {
+        return 0;
+    }
+    float fraction = magnitude >= _fullTilt ? 1 : (magnitude - _deadZone) / (_fullTilt - _deadZone);
+    float rate = _minRate + (_maxRate - _minRate) * std::pow(fraction, _exponent);
+    return tilt < 0 ? -rate : rate;
+}
+
+inline
+void TiltScroller::onOrientationData(Myo* myo, uint64_t timestamp, const Quaternion<float>& rotation)
+{
+    Track& t = _tracks.get(myo);
+    EulerAngles angles = toEuler(rotation);
+    t.angle = _axis == rollAxis ? angles.roll : angles.pitch;
+
+    // Roll wraps around at +-pi, so a neutral angle near it would otherwise read as a full turn of tilt.
+    float rate = rateFor(wrapAngle(t.angle - t.neutral));
+    // Gaps in the stream do not count towards the next step.
+    bool continuous = t.timestamp && timestamp > t.timestamp && timestamp - t.timestamp <= maxStreamGap;
+    float dt = continuous ? (timestamp - t.timestamp) * 1e-6f : 0;
+    t.timestamp = timestamp;
+
+    // Leaving the dead zone, or tilting the other way, scrolls one step straight away.
+    int direction = rate < 0 ? -1 : (rate > 0 ? 1 : 0);
+    if (direction != t.direction) {
+        t.direction = direction;
+        t.progress = 0;
+        if (direction) {
+            onScroll(myo, timestamp, direction);
+        }
+        return;
+    }
+    if (!direction) {
+        return;
+    }
+
+    t.progress += std::fabs(rate) * dt;
+    int steps = static_cast<int>(t.progress);
+    if (steps) {
+        t.progress -= steps;
+        onScroll(myo, timestamp, direction * steps);
+    }
+}
+
+inline
+void TiltScroller::onDisconnect(Myo* myo, uint64_t timestamp)
+{
+    _tracks.erase(myo);
+}
+
+inline
+void TiltScroller::onUnpair(Myo* myo, uint64_t timestamp)
+{
+    onDisconnect(myo, timestamp);
+}
+
+} // namespace myo
@@ -5,7 +5,12 @@
 /// The namespace in which all of the %Myo C++ bindings are contained.
 namespace myo {}
 
+#include "cxx/DeviceEvent.hpp"
+#include "cxx/DeviceHealth.hpp"
+#include "cxx/DeviceState.hpp"
 #include "cxx/DeviceListener.hpp"
+#include "cxx/DispatchObserver.hpp"
+#include "cxx/ErrorCode.hpp"
 #include "cxx/Hub.hpp"
 #include "cxx/Myo.hpp"
 #include "cxx/Pose.hpp"
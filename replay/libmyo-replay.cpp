@@ -0,0 +1,422 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+
+// Replay implementation of the libmyo C API. Instead of connecting to Myo Connect, a hub plays back an event log
+// written by myo::EventRecorder. See libmyo-replay.h for how playback is controlled.
+
+#include "libmyo-replay.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <string>
+#include <thread>
+
+#include <myo/cxx/EventLog.hpp>
+
+namespace {
+
+struct ErrorDetails {
+    libmyo_result_t kind;
+    std::string message;
+};
+
+struct ReplayMyo {
+    uint64_t macAddress;
+};
+
+// The event handed to handlers. Holds the decoded record along with the handle of the Myo it belongs to.
+struct ReplayEvent {
+    myo::EventRecord record;
+    ReplayMyo* myo;
+};
+
+struct ReplayHub {
+    explicit ReplayHub(const std::string& path)
+    : reader(path)
+    , myos()
+    , next()
+    , hasNext(false)
+    , clock(0)
+    {
+        advance();
+        if (hasNext) {
+            clock = next.record.event.timestamp;
+        }
+    }
+
+    // Read the next record from the log into next.
+    void advance()
+    {
+        try {
+            hasNext = reader.next(next.record);
+        } catch (const std::exception&) {
+            // Treat a damaged tail, e.g. from a recording that was cut short, as the end of the log.
+            hasNext = false;
+        }
+
+        if (hasNext) {
+            while (myos.size() <= next.record.device) {
+                ReplayMyo myo = { reader.devices()[myos.size()] };
+                myos.push_back(myo);
+            }
+            next.myo = &myos[next.record.device];
+        }
+    }
+
+    myo::EventLogReader reader;
+    std::deque<ReplayMyo> myos; // A deque keeps handles stable as devices are added.
+    ReplayEvent next;
+    bool hasNext;
+    uint64_t clock; // Recorded time, in microseconds, up to which the log has been played back.
+};
+
+std::string replayFile;
+bool replayFileSet = false;
+double replaySpeed = 0;
+bool replaySpeedSet = false;
+
+libmyo_result_t fail(libmyo_error_details_t* out_error, libmyo_result_t kind, const std::string& message)
+{
+    if (out_error) {
+        ErrorDetails* details = new ErrorDetails;
+        details->kind = kind;
+        details->message = message;
+        *out_error = details;
+    }
+    return kind;
+}
+
+libmyo_string_t makeString(const std::string& value)
+{
+    return new std::string(value);
+}
+
+double currentSpeed()
+{
+    if (!replaySpeedSet) {
+        const char* speed = std::getenv("MYO_REPLAY_SPEED");
+        replaySpeed = speed ? std::atof(speed) : 0;
+        replaySpeedSet = true;
+    }
+    return replaySpeed;
+}
+
+const myo::DeviceEvent& decoded(libmyo_event_t event)
+{
+    return static_cast<const ReplayEvent*>(event)->record.event;
+}
+
+} // namespace
+
+extern "C" {
+
+void libmyo_replay_set_file(const char* path)
+{
+    replayFile = path ? path : "";
+    replayFileSet = true;
+}
+
+void libmyo_replay_set_speed(double speed)
+{
+    replaySpeed = speed;
+    replaySpeedSet = true;
+}
+
+int libmyo_replay_finished(libmyo_hub_t hub)
+{
+    return hub ? !static_cast<ReplayHub*>(hub)->hasNext : 1;
+}
+
+const char* libmyo_error_cstring(libmyo_error_details_t details)
+{
+    return static_cast<ErrorDetails*>(details)->message.c_str();
+}
+
+libmyo_result_t libmyo_error_kind(libmyo_error_details_t details)
+{
+    return static_cast<ErrorDetails*>(details)->kind;
+}
+
+void libmyo_free_error_details(libmyo_error_details_t details)
+{
+    delete static_cast<ErrorDetails*>(details);
+}
+
+const char* libmyo_string_c_str(libmyo_string_t string)
+{
+    return static_cast<std::string*>(string)->c_str();
+}
+
+void libmyo_string_free(libmyo_string_t string)
+{
+    delete static_cast<std::string*>(string);
+}
+
+libmyo_string_t libmyo_mac_address_to_string(uint64_t address)
+{
+    char buffer[18];
+    std::sprintf(buffer, "%02x-%02x-%02x-%02x-%02x-%02x",
+                 static_cast<unsigned int>((address >> 40) & 0xff), static_cast<unsigned int>((address >> 32) & 0xff),
+                 static_cast<unsigned int>((address >> 24) & 0xff), static_cast<unsigned int>((address >> 16) & 0xff),
+                 static_cast<unsigned int>((address >> 8) & 0xff), static_cast<unsigned int>(address & 0xff));
+    return makeString(buffer);
+}
+
+uint64_t libmyo_string_to_mac_address(const char* string)
+{
+    unsigned int bytes[6];
+    char trailing;
+    if (!string || std::sscanf(string, "%2x-%2x-%2x-%2x-%2x-%2x%c", &bytes[0], &bytes[1], &bytes[2], &bytes[3],
+                               &bytes[4], &bytes[5], &trailing) != 6) {
+        return 0;
+    }
+
+    uint64_t address = 0;
+    for (int i = 0; i < 6; ++i) {
+        address = (address << 8) | bytes[i];
+    }
+    return address;
+}
+
+libmyo_result_t libmyo_init_hub(libmyo_hub_t* out_hub, const char* application_identifier,
+                                libmyo_error_details_t* out_error)
+{
+    if (!out_hub) {
+        return fail(out_error, libmyo_error_invalid_argument, "out_hub is NULL");
+    }
+    if (application_identifier && std::strlen(application_identifier) > 255) {
+        return fail(out_error, libmyo_error_invalid_argument, "application_identifier is too long");
+    }
+
+    std::string path = replayFile;
+    if (!replayFileSet) {
+        const char* file = std::getenv("MYO_REPLAY_FILE");
+        path = file ? file : "";
+    }
+    if (path.empty()) {
+        return fail(out_error, libmyo_error_runtime, "No event log to replay; set MYO_REPLAY_FILE");
+    }
+
+    try {
+        *out_hub = new ReplayHub(path);
+    } catch (const std::exception& e) {
+        return fail(out_error, libmyo_error_runtime, e.what());
+    }
+    return libmyo_success;
+}
+
+libmyo_result_t libmyo_shutdown_hub(libmyo_hub_t hub, libmyo_error_details_t* out_error)
+{
+    if (!hub) {
+        return fail(out_error, libmyo_error_invalid_argument, "hub is NULL");
+    }
+    delete static_cast<ReplayHub*>(hub);
+    return libmyo_success;
+}
+
+libmyo_result_t libmyo_set_locking_policy(libmyo_hub_t hub, libmyo_locking_policy_t locking_policy,
+                                          libmyo_error_details_t* out_error)
+{
+    // Lock and pose events are played back exactly as they were recorded.
+    if (!hub) {
+        return fail(out_error, libmyo_error_invalid_argument, "hub is NULL");
+    }
+    return libmyo_success;
+}
+
+uint64_t libmyo_get_mac_address(libmyo_myo_t myo)
+{
+    return myo ? static_cast<ReplayMyo*>(myo)->macAddress : 0;
+}
+
+// Commands sent to a Myo have no effect during playback.
+
+libmyo_result_t libmyo_vibrate(libmyo_myo_t myo, libmyo_vibration_type_t type, libmyo_error_details_t* out_error)
+{
+    return myo ? libmyo_success : fail(out_error, libmyo_error_invalid_argument, "myo is NULL");
+}
+
+libmyo_result_t libmyo_request_rssi(libmyo_myo_t myo, libmyo_error_details_t* out_error)
+{
+    return myo ? libmyo_success : fail(out_error, libmyo_error_invalid_argument, "myo is NULL");
+}
+
+libmyo_result_t libmyo_request_battery_level(libmyo_myo_t myo, libmyo_error_details_t* out_error)
+{
+    return myo ? libmyo_success : fail(out_error, libmyo_error_invalid_argument, "myo is NULL");
+}
+
+libmyo_result_t libmyo_set_stream_emg(libmyo_myo_t myo, libmyo_stream_emg_t emg, libmyo_error_details_t* out_error)
+{
+    return myo ? libmyo_success : fail(out_error, libmyo_error_invalid_argument, "myo is NULL");
+}
+
+libmyo_result_t libmyo_myo_unlock(libmyo_myo_t myo, libmyo_unlock_type_t type, libmyo_error_details_t* out_error)
+{
+    return myo ? libmyo_success : fail(out_error, libmyo_error_invalid_argument, "myo is NULL");
+}
+
+libmyo_result_t libmyo_myo_lock(libmyo_myo_t myo, libmyo_error_details_t* out_error)
+{
+    return myo ? libmyo_success : fail(out_error, libmyo_error_invalid_argument, "myo is NULL");
+}
+
+libmyo_result_t libmyo_myo_notify_user_action(libmyo_myo_t myo, libmyo_user_action_type_t type,
+                                              libmyo_error_details_t* out_error)
+{
+    return myo ? libmyo_success : fail(out_error, libmyo_error_invalid_argument, "myo is NULL");
+}
+
+uint32_t libmyo_event_get_type(libmyo_event_t event)
+{
+    return decoded(event).type;
+}
+
+uint64_t libmyo_event_get_timestamp(libmyo_event_t event)
+{
+    return decoded(event).timestamp;
+}
+
+libmyo_myo_t libmyo_event_get_myo(libmyo_event_t event)
+{
+    return static_cast<const ReplayEvent*>(event)->myo;
+}
+
+uint64_t libmyo_event_get_mac_address(libmyo_event_t event)
+{
+    return static_cast<const ReplayEvent*>(event)->record.macAddress;
+}
+
+libmyo_string_t libmyo_event_get_myo_name(libmyo_event_t event)
+{
+    // Names are not recorded; identify the Myo by its MAC address instead.
+    libmyo_string_t address = libmyo_mac_address_to_string(libmyo_event_get_mac_address(event));
+    std::string* name = static_cast<std::string*>(address);
+    name->insert(0, "Myo ");
+    return name;
+}
+
+unsigned int libmyo_event_get_firmware_version(libmyo_event_t event, libmyo_version_component_t component)
+{
+    const myo::FirmwareVersion& version = decoded(event).firmwareVersion;
+    switch (component) {
+    case libmyo_version_major:
+        return version.firmwareVersionMajor;
+    case libmyo_version_minor:
+        return version.firmwareVersionMinor;
+    case libmyo_version_patch:
+        return version.firmwareVersionPatch;
+    case libmyo_version_hardware_rev:
+        return version.firmwareVersionHardwareRev;
+    }
+    return 0;
+}
+
+libmyo_arm_t libmyo_event_get_arm(libmyo_event_t event)
+{
+    return static_cast<libmyo_arm_t>(decoded(event).armSync.arm);
+}
+
+libmyo_x_direction_t libmyo_event_get_x_direction(libmyo_event_t event)
+{
+    return static_cast<libmyo_x_direction_t>(decoded(event).armSync.xDirection);
+}
+
+libmyo_warmup_state_t libmyo_event_get_warmup_state(libmyo_event_t event)
+{
+    return static_cast<libmyo_warmup_state_t>(decoded(event).armSync.warmupState);
+}
+
+libmyo_warmup_result_t libmyo_event_get_warmup_result(libmyo_event_t event)
+{
+    return static_cast<libmyo_warmup_result_t>(decoded(event).warmupResult);
+}
+
+float libmyo_event_get_rotation_on_arm(libmyo_event_t event)
+{
+    return decoded(event).armSync.rotation;
+}
+
+float libmyo_event_get_orientation(libmyo_event_t event, libmyo_orientation_index index)
+{
+    return decoded(event).imu.orientation[index];
+}
+
+float libmyo_event_get_accelerometer(libmyo_event_t event, unsigned int index)
+{
+    return decoded(event).imu.accelerometer[index];
+}
+
+float libmyo_event_get_gyroscope(libmyo_event_t event, unsigned int index)
+{
+    return decoded(event).imu.gyroscope[index];
+}
+
+libmyo_pose_t libmyo_event_get_pose(libmyo_event_t event)
+{
+    return static_cast<libmyo_pose_t>(decoded(event).pose);
+}
+
+int8_t libmyo_event_get_rssi(libmyo_event_t event)
+{
+    return decoded(event).rssi;
+}
+
+uint8_t libmyo_event_get_battery_level(libmyo_event_t event)
+{
+    return decoded(event).batteryLevel;
+}
+
+int8_t libmyo_event_get_emg(libmyo_event_t event, unsigned int sensor)
+{
+    return decoded(event).emg[sensor];
+}
+
+libmyo_result_t libmyo_run(libmyo_hub_t hub_opq, unsigned int duration_ms, libmyo_handler_t handler, void* user_data,
+                           libmyo_error_details_t* out_error)
+{
+    if (!hub_opq) {
+        return fail(out_error, libmyo_error_invalid_argument, "hub is NULL");
+    }
+    if (!handler) {
+        return fail(out_error, libmyo_error_invalid_argument, "handler is NULL");
+    }
+
+    ReplayHub* hub = static_cast<ReplayHub*>(hub_opq);
+    const double speed = currentSpeed();
+    const uint64_t start = hub->clock;
+    const uint64_t end = start + static_cast<uint64_t>(duration_ms) * 1000;
+    const std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+
+    while (hub->hasNext && hub->next.record.event.timestamp <= end) {
+        const uint64_t timestamp = hub->next.record.event.timestamp;
+        if (timestamp > hub->clock) {
+            hub->clock = timestamp;
+        }
+
+        if (speed > 0) {
+            std::this_thread::sleep_until(wallStart + std::chrono::microseconds(
+                static_cast<long long>((hub->clock - start) / speed)));
+        }
+
+        libmyo_handler_result_t result = handler(user_data, &hub->next);
+        hub->advance();
+
+        if (result == libmyo_handler_stop) {
+            return libmyo_success;
+        }
+    }
+
+    hub->clock = end;
+    if (speed > 0) {
+        std::this_thread::sleep_until(wallStart + std::chrono::microseconds(
+            static_cast<long long>((end - start) / speed)));
+    }
+    return libmyo_success;
+}
+
+} // extern "C"
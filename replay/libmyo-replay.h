@@ -0,0 +1,40 @@
+// Copyright (C) 2013-2014 Thalmic Labs Inc.
+// Distributed under the Myo SDK license agreement. See LICENSE.txt for details.
+#ifndef MYO_LIBMYO_REPLAY_H
+#define MYO_LIBMYO_REPLAY_H
+
+#include <myo/libmyo.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @file libmyo-replay.h
+/// Controls specific to the replay implementation of libmyo.
+///
+/// The replay implementation plays back an event log written by myo::EventRecorder in place of talking to Myo
+/// Connect. Playback is driven by libmyo_run(): each call advances the log by exactly \a duration_ms milliseconds of
+/// recorded time, so the sequence of events delivered does not depend on how fast the application runs. The
+/// playback speed only decides how long libmyo_run() takes in wall-clock time.
+///
+/// The log and speed can also be chosen with the MYO_REPLAY_FILE and MYO_REPLAY_SPEED environment variables, which
+/// are read by libmyo_init_hub() unless overridden with the functions below.
+
+/// Set the event log that the next call to libmyo_init_hub() will play back.
+LIBMYO_EXPORT
+void libmyo_replay_set_file(const char* path);
+
+/// Set the playback speed as a multiple of real time. A \a speed of 0, the default, plays back as fast as possible.
+/// Takes effect on the next call to libmyo_run().
+LIBMYO_EXPORT
+void libmyo_replay_set_speed(double speed);
+
+/// Return non-zero once every event in the log of \a hub has been delivered.
+LIBMYO_EXPORT
+int libmyo_replay_finished(libmyo_hub_t hub);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // MYO_LIBMYO_REPLAY_H
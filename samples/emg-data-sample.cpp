@@ -10,11 +10,16 @@
 #include <string>
 
 #include <myo/myo.hpp>
+#include <myo/cxx/EmgFeatures.hpp>
 
-class DataCollector : public myo::DeviceListener {
+class DataCollector : public myo::EmgFeatureExtractor {
 public:
+    // EmgFeatureExtractor computes features over a sliding window of EMG samples. Here the window holds 40 samples
+    // (200 ms at 200 Hz) and the features are updated every 10 samples.
     DataCollector()
-    : emgSamples()
+    : myo::EmgFeatureExtractor(40, 10)
+    , emgSamples()
+    , emgRms()
     {
     }
 
@@ -24,6 +29,8 @@ public:
         // We've lost a Myo.
         // Let's clean up some leftover state.
         emgSamples.fill(0);
+        emgRms.fill(0);
+        myo::EmgFeatureExtractor::onUnpair(myo, timestamp);
     }
 
     // onEmgData() is called whenever a paired Myo has provided new EMG data, and EMG streaming is enabled.
@@ -32,6 +39,17 @@ public:
         for (int i = 0; i < 8; i++) {
             emgSamples[i] = emg[i];
         }
+
+        // Let the extractor add the sample to its window.
+        myo::EmgFeatureExtractor::onEmgData(myo, timestamp, emg);
+    }
+
+    // onEmgFeatures() is called by EmgFeatureExtractor every time the window has moved on by 10 samples.
+    void onEmgFeatures(myo::Myo* myo, const myo::EmgFeatures& features)
+    {
+        for (int i = 0; i < 8; i++) {
+            emgRms[i] = features.rms[i];
+        }
     }
 
     // There are other virtual functions in DeviceListener that we could override here, like onAccelerometerData().
@@ -52,11 +70,24 @@ public:
             std::cout << '[' << emgString << std::string(4 - emgString.size(), ' ') << ']';
         }
 
+        // Print out the RMS of each sensor over the last window, which tracks muscle activity more steadily.
+        std::cout << "  RMS:";
+        for (size_t i = 0; i < emgRms.size(); i++) {
+            std::ostringstream oss;
+            oss << static_cast<int>(emgRms[i] + 0.5f);
+            std::string rmsString = oss.str();
+
+            std::cout << '[' << rmsString << std::string(4 - rmsString.size(), ' ') << ']';
+        }
+
         std::cout << std::flush;
     }
 
     // The values of this array is set by onEmgData() above.
     std::array<int8_t, 8> emgSamples;
+
+    // The values of this array are set by onEmgFeatures() above.
+    std::array<float, 8> emgRms;
 };
 
 int main(int argc, char** argv)
@@ -91,8 +122,9 @@ int main(int argc, char** argv)
     DataCollector collector;
 
     // Hub::addListener() takes the address of any object whose class inherits from DeviceListener, and will cause
-    // Hub::run() to send events to all registered device listeners.
-    hub.addListener(&collector);
+    // Hub::run() to send events to all registered device listeners. The second argument subscribes the listener to
+    // just the events it handles, so the hub does not decode anything else for it.
+    hub.addListener(&collector, myo::Hub::eventEmg | myo::Hub::eventDisconnected | myo::Hub::eventUnpaired);
 
     // Finally we enter our main loop.
     while (1) {
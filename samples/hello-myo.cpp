@@ -13,10 +13,13 @@ doubleTap
 #include <stdexcept>
 #include <string>
 #include <algorithm>
-#include <chrono>
-#include <thread>
 
 #include <myo/myo.hpp> // The only file that needs to be included to use the Myo C++ SDK is myo.hpp.
+#include <myo/cxx/EulerAngles.hpp>
+#include <myo/cxx/GestureMatcher.hpp>
+#include <myo/cxx/GestureRecorder.hpp>
+#include <myo/cxx/PoseTracker.hpp>
+#include <myo/cxx/TiltScroller.hpp>
 
 const int MESSAGESIZE = 11;
 const int EMOJISIZE = 11;
@@ -27,7 +30,7 @@ const int EMOJISIZE = 11;
 class DataCollector : public myo::DeviceListener {
 public:
     DataCollector()
-    : onArm(false), isUnlocked(false), roll_w(0), pitch_w(0), yaw_w(0), currentPose()
+    : onArm(false), isUnlocked(false), roll_w(0), pitch_w(0), yaw_w(0), currentPose(), matcher(), lastMatch(-1)
     {
     }
 
@@ -41,29 +44,25 @@ public:
         yaw_w = 0;
         onArm = false;
         isUnlocked = false;
+        matcher.reset();
     }
 
     // onOrientationData() is called whenever the Myo device provides its current orientation, which is represented
     // as a unit quaternion.
     void onOrientationData(myo::Myo* myo, uint64_t timestamp, const myo::Quaternion<float>& quat)
     {
-        using std::atan2;
-        using std::asin;
-        using std::sqrt;
-        using std::max;
-        using std::min;
-
-        // Calculate Euler angles (roll, pitch, and yaw) from the unit quaternion.
-        float roll = atan2(2.0f * (quat.w() * quat.x() + quat.y() * quat.z()),
-                           1.0f - 2.0f * (quat.x() * quat.x() + quat.y() * quat.y()));
-        float pitch = asin(max(-1.0f, min(1.0f, 2.0f * (quat.w() * quat.y() - quat.z() * quat.x()))));
-        float yaw = atan2(2.0f * (quat.w() * quat.z() + quat.x() * quat.y()),
-                        1.0f - 2.0f * (quat.y() * quat.y() + quat.z() * quat.z()));
-
-        // Convert the floating point angles in radians to a scale from 0 to 18.
-        roll_w = static_cast<int>((roll + (float)M_PI)/(M_PI * 2.0f) * 18);
-        pitch_w = static_cast<int>((pitch + (float)M_PI/2.0f)/M_PI * 18);
-        yaw_w = static_cast<int>((yaw + (float)M_PI)/(M_PI * 2.0f) * 18);
+        // Calculate Euler angles (roll, pitch, and yaw) from the unit quaternion, and convert them to a scale from
+        // 0 to 17.
+        myo::EulerBuckets angles = myo::toEulerBuckets(quat, 18);
+        roll_w = angles.roll;
+        pitch_w = angles.pitch;
+        yaw_w = angles.yaw;
+
+        // Compare the latest orientations against the recorded gesture.
+        myo::GestureMatcher::Match match;
+        if (matcher.update(myo::toEuler(quat), match)) {
+            lastMatch = static_cast<int>(match.templateIndex);
+        }
     }
 
     // onPose() is called whenever the Myo detects that the person wearing it has changed their pose, for example,
@@ -134,18 +133,21 @@ public:
         if (onArm) {
             // Print out the lock state, the currently recognized pose, and which arm Myo is being worn on.
 
-            // Pose::toString() provides the human-readable name of a pose. We can also output a Pose directly to an
-            // output stream (e.g. std::cout << currentPose;). In this case we want to get the pose name's length so
-            // that we can fill the rest of the field with spaces below, so we obtain it as a string using toString().
-            std::string poseString = currentPose.toString();
-
+            // Pose::name() provides the human-readable name of a pose without allocating. We can also output a Pose
+            // directly to an output stream (e.g. std::cout << currentPose;), but here we pad the name to a fixed
+            // width so that the rest of the line stays in place.
             std::cout << '[' << (isUnlocked ? "unlocked" : "locked  ") << ']'
                       << '[' << (whichArm == myo::armLeft ? "L" : "R") << ']'
-                      << '[' << poseString << std::string(14 - poseString.size(), ' ') << ']';
+                      << '[' << std::left << std::setw(14) << currentPose.name() << std::right << ']';
         } else {
             // Print out a placeholder for the arm and pose when Myo doesn't currently know which arm it's on.
             std::cout << '[' << std::string(8, ' ') << ']' << "[?]" << '[' << std::string(14, ' ') << ']';
         }
+
+        // Print out the most recently recognized gesture.
+        if (lastMatch >= 0) {
+            std::cout << "[gesture " << lastMatch << ']';
+        }
 		
 
         std::cout << std::flush;
@@ -161,120 +163,145 @@ public:
     // These values are set by onOrientationData() and onPose() above.
     int roll_w, pitch_w, yaw_w;
     myo::Pose currentPose;
+
+    // The gesture recorded most recently by GestureCollector below is matcher's only template. lastMatch is the index
+    // of the template matched most recently, or -1.
+    myo::GestureMatcher matcher;
+    int lastMatch;
 };
 
-class Movement
+// GestureRecorder splits the orientation stream into movements as events arrive, so recording a gesture never blocks
+// the event loop or the menus below. We keep the most recently completed gesture so that it can be printed, and make
+// it the DataCollector's only template so that it is recognized when it is performed again.
+class GestureCollector : public myo::GestureRecorder
 {
 public:
-	int changePitch, changeYaw, changeRoll;
-
-	Movement()
+	explicit GestureCollector(DataCollector & collector)
+	: recorded(false), collector(collector)
 	{
-		changePitch = 0;
-		changeYaw = 0;
-		changeRoll = 0;
 	}
 
-	bool recordMovement(DataCollector & collector, myo::Hub & hub) //BAD CODING PRACTICE, MAKE A CONSTRUCTOR
+	void onGesture(myo::Myo* myo, uint64_t timestamp, const myo::Gesture& gesture)
 	{
-		hub.run(1000 / 20); //Potentially erroneous 
-		
-		int initPitch = collector.pitch_w;
-		int initYaw = collector.yaw_w; //take the distance one way and then the opposite way; use whichever is shortest (SINCE YAW STARTS ON THE EDGE)
-		int initRoll = collector.roll_w;
-
-		hub.run(1000/20);
-
-		while (abs(initPitch - collector.pitch_w) < 3 && abs(initRoll - collector.pitch_w) < 3 && abs(initYaw - collector.yaw_w) < 3)
-		{
-			hub.run(1000 / 20);
-		}
-
-		std::this_thread::sleep_for(std::chrono::milliseconds(900));
-
-		hub.run(1000 / 20);
+		lastGesture = gesture;
+		recorded = true;
+
+		// Replace the previous gesture rather than adding to it, so that the matching cost stays the same however
+		// many gestures are recorded. The stream is forgotten afterwards, because it still holds the samples of the
+		// gesture itself, which would otherwise match right away.
+		collector.matcher.clearTemplates();
+		collector.matcher.addTemplate(gesture.samples);
+		collector.matcher.reset();
+		collector.lastMatch = -1;
+	}
 
-		(*this).changePitch = collector.pitch_w - initPitch;
-		(*this).changeRoll = collector.roll_w - initRoll;
-		(*this).changeYaw = collector.yaw_w - initYaw;
-		return true;
+	bool recorded;
+	myo::Gesture lastGesture;
 
-		//hub.run(1000 / 20);
-		//initPitch = collector.pitch_w;
-		//initYaw = collector.yaw_w;
-		//initRoll = collector.roll_w;
-	}
+private:
+	DataCollector & collector;
 };
 
-class Gesture
+// MenuScroller scrolls the emoji and message menus as the arm is tilted up or down. Steps are counted as orientation
+// events arrive, so the menus can pick them up once per display update without pausing the event loop.
+class MenuScroller : public myo::TiltScroller
 {
 public:
-	Movement movements[3];
+	MenuScroller()
+	: pendingSteps(0)
+	{
+	}
 
-	Gesture()
-	{}
+	void onScroll(myo::Myo* myo, uint64_t timestamp, int steps)
+	{
+		pendingSteps += steps;
+	}
 
-	bool recordGesture(DataCollector & collector, myo::Hub & hub)
+	// Return the steps scrolled since the last call.
+	int takeSteps()
 	{
-		for (int i = 0; i < 3; i++)
-		{
-			(*this).movements[i].recordMovement(collector, hub);
-			std::this_thread::sleep_for(std::chrono::milliseconds(900));
-		}
-		return true;
+		int steps = pendingSteps;
+		pendingSteps = 0;
+		return steps;
 	}
+
+private:
+	int pendingSteps;
 };
 
-void emojiMenu(DataCollector & collector, std::string emojis[], int & currentPosition, bool & breakLoop)
+// MenuPoses turns the pose stream into the transitions the menus react to: a pose being entered, and a pose being
+// held for half a second. Transitions are kept as they arrive, so that the menus react to each one exactly once
+// instead of to whatever pose happens to be current when the display is updated.
+class MenuPoses : public myo::PoseTracker
 {
-	int scrollDelay = 4200 / (pow(abs(collector.pitch_w - 8) + 1, 1.5) + 5 );
+public:
+	MenuPoses()
+	: myo::PoseTracker(500000), entered(myo::Pose::unknown), held(myo::Pose::unknown)
+	{
+	}
 
-	std::cout << scrollDelay;
+	void onPoseEnter(myo::Myo* myo, uint64_t timestamp, myo::Pose pose)
+	{
+		entered = pose.type();
+	}
 
-	std::cout << "The current position(Emoji) is " << currentPosition << std::endl;
+	void onPoseHold(myo::Myo* myo, uint64_t timestamp, myo::Pose pose, uint64_t duration)
+	{
+		held = pose.type();
+	}
 
-	if (collector.pitch_w > 10 && currentPosition < (EMOJISIZE-1))
+	// Return the pose entered since the last call, or Pose::unknown.
+	myo::Pose::Type takeEntered()
 	{
-			currentPosition++;
-		std::cout << "The current position(Emoji) is " << currentPosition << std::endl;
+		myo::Pose::Type pose = entered;
+		entered = myo::Pose::unknown;
+		return pose;
 	}
-	else if (collector.pitch_w < 7 && currentPosition > 0)
+
+	// Return the pose held since the last call, or Pose::unknown.
+	myo::Pose::Type takeHeld()
 	{
-		currentPosition--;
-		std::cout << "The current position(Emoji) is " << currentPosition << std::endl;
+		myo::Pose::Type pose = held;
+		held = myo::Pose::unknown;
+		return pose;
 	}
 
-	std::this_thread::sleep_for(std::chrono::milliseconds(scrollDelay));
+private:
+	myo::Pose::Type entered;
+	myo::Pose::Type held;
+};
 
-	if (collector.currentPose.toString() == "fingersSpread")
+void scrollMenu(int steps, int size, int & currentPosition)
+{
+	if (steps == 0)
 	{
-		breakLoop = true;
-		std::cout << "Ready to cout: " << emojis[currentPosition] << std::endl;
+		return;
 	}
+
+	currentPosition = std::max(0, std::min(size - 1, currentPosition + steps));
 }
 
-void messageMenu(DataCollector & collector, std::string messages[], int & currentPosition, bool & breakLoop)
+void emojiMenu(myo::Pose::Type held, int steps, std::string emojis[], int & currentPosition, bool & breakLoop)
 {
-	int scrollDelay = 4200 / (pow(abs(collector.pitch_w - 8) + 1, 1.5) + 5);
+	scrollMenu(steps, EMOJISIZE, currentPosition);
 
-	std::cout << scrollDelay;
-
-	std::cout << "The current position(Message) is " << currentPosition << std::endl;
+	std::cout << "The current position(Emoji) is " << currentPosition << std::endl;
 
-	if (collector.pitch_w > 10 && currentPosition < (MESSAGESIZE-1))
-	{
-		currentPosition++;
-		std::cout << "The current position(Message) is " << currentPosition << std::endl;
-	}
-	else if (collector.pitch_w < 7 && currentPosition > 0)
+	// Holding fingersSpread picks the current entry, so that passing through the pose doesn't.
+	if (held == myo::Pose::fingersSpread)
 	{
-		currentPosition--;
-		std::cout << "The current position(Message) is " << currentPosition << std::endl;
+		breakLoop = true;
+		std::cout << "Ready to cout: " << emojis[currentPosition] << std::endl;
 	}
+}
 
-	std::this_thread::sleep_for(std::chrono::milliseconds(scrollDelay));
+void messageMenu(myo::Pose::Type held, int steps, std::string messages[], int & currentPosition, bool & breakLoop)
+{
+	scrollMenu(steps, MESSAGESIZE, currentPosition);
 
-	if (collector.currentPose.toString() == "fingersSpread")
+	std::cout << "The current position(Message) is " << currentPosition << std::endl;
+
+	if (held == myo::Pose::fingersSpread)
 	{
 		breakLoop = true;
 		std::cout << "Ready to cout: " << messages[currentPosition] << std::endl;
@@ -311,6 +338,10 @@ int main(int argc, char** argv)
 	// We've found a Myo.
 	std::cout << "Connected to a Myo armband!" << std::endl << std::endl;
 
+	// onPose() below unlocks the Myo and notifies the user on every pose change. Queueing these commands lets the Hub
+	// merge the redundant ones and send the rest between event slices, at a rate the Bluetooth link can carry.
+	hub.setCommandRate(10);
+
 	// Next we construct an instance of our DeviceListener, so that we can register it with the Hub.
 	DataCollector collector;
 
@@ -318,6 +349,19 @@ int main(int argc, char** argv)
 	// Hub::run() to send events to all registered device listeners.
 	hub.addListener(&collector);
 
+	// The gesture recorder receives the same orientation events and records gestures of three movements.
+	GestureCollector gestures(collector);
+	hub.addListener(&gestures);
+
+	// The menu scroller turns tilting the arm into menu steps.
+	MenuScroller scroller;
+	hub.addListener(&scroller, myo::Hub::eventOrientation | myo::Hub::eventDisconnected | myo::Hub::eventUnpaired);
+
+	// The menu poses track pose transitions; orientation events time the holds.
+	MenuPoses poses;
+	hub.addListener(&poses, myo::Hub::eventPose | myo::Hub::eventOrientation | myo::Hub::eventDisconnected
+	                        | myo::Hub::eventUnpaired);
+
 	// Finally we enter our main loop.
 
 	
@@ -337,12 +381,6 @@ int main(int argc, char** argv)
 		bool breakLoopEmoji = false;
 		int whichMenu = 0;
 	
-		//Movement move1;
-		//bool recorded = false;
-
-		Gesture g1;
-		bool recorded = false;
-
 		while (true)
 		{
 
@@ -353,30 +391,29 @@ int main(int argc, char** argv)
 			// obtained from any events that have occurred.
 			collector.print();
 
-
-			if (recorded == false)
+			// Print the change of pitch, roll and yaw of each movement of the last recorded gesture, in degrees.
+			if (gestures.recorded)
 			{
-				recorded = g1.recordGesture(collector, hub);
+				for (size_t i = 0; i < gestures.lastGesture.movements.size(); i++)
+				{
+					const myo::EulerAngles& change = gestures.lastGesture.movements[i].change;
+					std::cout << static_cast<int>(change.pitch * 180 / M_PI) << ' '
+					          << static_cast<int>(change.roll * 180 / M_PI) << ' '
+					          << static_cast<int>(change.yaw * 180 / M_PI) << "   ";
+				}
 			}
-			
-			for (int i = 0; i < 3; i++)
-			{
-				std::cout << g1.movements[i].changePitch << g1.movements[i].changeRoll << g1.movements[i].changeYaw << "   ";
-			}
-			
 
+			// Steps scrolled while the events were processed; they are only used while a menu is shown.
+			int steps = scroller.takeSteps();
 
-			/*if (recorded == false)
-			{
-				recorded = move1.recordMovement(collector, hub);
-			}
-			std::cout << move1.changePitch << move1.changeRoll << move1.changeYaw; */
-
+			// Pose transitions since the last display update.
+			myo::Pose::Type entered = poses.takeEntered();
+			myo::Pose::Type held = poses.takeHeld();
 
 			switch (whichMenu)
 			{
 				case MESSAGEMENU:
-					messageMenu(collector, messages, currentPosition, breakLoopMessage);
+					messageMenu(held, steps, messages, currentPosition, breakLoopMessage);
 					//if command to return to mainMenu, return to mainMenu
 					if (breakLoopMessage == true)
 					{	
@@ -385,7 +422,7 @@ int main(int argc, char** argv)
 					}
 
 				case EMOJIMENU:
-					emojiMenu(collector, emojis, currentPosition, breakLoopEmoji);
+					emojiMenu(held, steps, emojis, currentPosition, breakLoopEmoji);
 					//if command to return to mainMenu, return to mainMenu
 					if (breakLoopEmoji == true)
 					{	
@@ -394,12 +431,12 @@ int main(int argc, char** argv)
 					}
 					
 				default:
-					if (collector.currentPose.toString() == "waveIn")
+					if (entered == myo::Pose::waveIn)
 					{
 						std::cout << "TextMenu " << std::endl;
 						whichMenu = MESSAGEMENU;
 					}
-					else if (collector.currentPose.toString() == "waveOut") //MAYBE REMOVE "ELSE"
+					else if (entered == myo::Pose::waveOut) //MAYBE REMOVE "ELSE"
 					{
 						std::cout << "EmojiMenu " << std::endl;
 						whichMenu = EMOJIMENU;
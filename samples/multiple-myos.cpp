@@ -35,7 +35,7 @@ public:
 
     void onPose(myo::Myo* myo, uint64_t timestamp, myo::Pose pose)
     {
-        std::cout << "Myo " << identifyMyo(myo) << " switched to pose " << pose.toString() << "." << std::endl;
+        std::cout << "Myo " << identifyMyo(myo) << " switched to pose " << pose.name() << "." << std::endl;
     }
 
     void onConnect(myo::Myo* myo, uint64_t timestamp, myo::FirmwareVersion firmwareVersion)